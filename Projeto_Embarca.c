@@ -7,6 +7,11 @@
 // Bibliotecas específicas do Raspberry Pi Pico e periféricos
 #include "pico/stdlib.h"      // Funções padrão para Raspberry Pi Pico (GPIO, sleep, etc.)
 #include "ssd1306.h"          // Driver para o display OLED SSD1306
+#include "ssd1306_widget.h"   // Widgets com redesenho incremental para o display OLED
+#include "display_service.h"  // Envio agrupado do framebuffer com taxa máxima configurável
+#include "i2c_bus.h"          // Fila de transações I2C com DMA e prioridades
+#include "bmp280_driver.h"    // Driver do sensor de temperatura e pressão BMP280
+#include "env_sampler.h"      // Amostragem do BMP280 em segundo plano com janelas agregadas
 #include "hardware/i2c.h"     // Controle do barramento I2C
 #include "hardware/pwm.h"     // Controle do PWM, utilizado para os buzzers
 #include "ws2812b_animation.h"// Funções para controle da matriz de LEDs WS2812B
@@ -16,6 +21,17 @@
 #include "lwip/tcp.h"         // Funções para manipulação do protocolo TCP
 #include "lwip/dhcp.h"        // Protocolo DHCP para obtenção de IP
 #include "lwip/timeouts.h"    // Funções para gerenciamento de timeouts em conexões TCP
+#include "http_client.h"      // Cliente HTTP não bloqueante para a API de resultados
+#include "result_queue.h"     // Fila de resultados enviados em lotes
+#include "telemetry.h"        // Telemetria binária por UDP
+#include "result_log.h"       // Log em flash dos resultados enquanto não há rede
+#include "wifi_link.h"        // Conexão e reconexão Wi‑Fi em segundo plano
+#include "live_server.h"      // Servidor HTTP com o estado e os eventos da partida ao vivo
+#include "net_stats.h"        // Uso dos pools de memória do lwIP
+#include "net_clock.h"        // Relógio sincronizado por SNTP para os horários das rodadas
+#if NETWORK_ON_CORE1
+#include "net_core.h"         // Driver Wi‑Fi e lwIP em modo poll no núcleo 1
+#endif
 
 // ----- Definições para o Display OLED -----
 #define SCREEN_WIDTH 128      // Largura do display OLED
@@ -23,6 +39,13 @@
 #define SCREEN_ADDRESS 0x3C   // Endereço I2C do display OLED (geralmente 0x3C)
 #define I2C_SDA 14            // Pino SDA para comunicação I2C com o display
 #define I2C_SCL 15            // Pino SCL para comunicação I2C com o display
+#define DISPLAY_MAX_FPS 30    // Taxa máxima de envio do framebuffer ao display
+
+// ----- Definições para o sensor BMP280 -----
+#define SENSOR_I2C_SDA 0          // Pino SDA do i2c0 (conector de expansão)
+#define SENSOR_I2C_SCL 1          // Pino SCL do i2c0
+#define ENV_SAMPLE_RATE_HZ 10     // Conversões por segundo
+#define ENV_DECIMATION 10         // Amostras agregadas por janela (uma janela por segundo)
 
 // ----- Definições dos pinos e componentes do jogo -----
 #define BUZZER_A_PIN 21       // Pino do primeiro buzzer (A)
@@ -52,9 +75,19 @@
 // ----- Definições para Wi‑Fi e dados do servidor (API) -----
 #define WIFI_SSID "Felps"          // Nome da rede Wi‑Fi
 #define WIFI_PASSWORD "Felps2006@."     // Senha da rede Wi‑Fi
-#define API_HOST "192.168.125.63"    // Endereço IP do servidor da API
+#define API_HOST "192.168.125.63"    // Nome ou endereço IP do servidor da API (resolvido por DNS)
 #define API_PORT 5000                // Porta da API
-#define API_PATH "/game_result"      // Rota onde os resultados serão enviados
+#define API_PATH "/game_results"     // Rota que recebe os resultados em lote
+#define API_BATCH_SIZE 8             // Rodadas acumuladas que disparam um envio
+#define API_FLUSH_INTERVAL_MS 30000  // Envio periódico das rodadas pendentes
+#define TELEMETRY_PORT 5005          // Porta do receptor de telemetria (server/TelemetryReceiver.py)
+#define LIVE_SERVER_PORT 80          // Porta do painel e do fluxo de eventos para espectadores na rede local
+#define NTP_HOST API_HOST            // Servidor NTP (server/NtpStandIn.py); porta em NET_CLOCK_PORT
+
+// Transporte dos resultados: 0 = lotes HTTP para a API, 1 = telemetria UDP (um datagrama por rodada)
+#ifndef RESULT_TRANSPORT_UDP
+#define RESULT_TRANSPORT_UDP 0
+#endif
 
 // ----- Variáveis globais para os slices PWM dos buzzers -----
 uint slice_num_a;  // Slice do PWM para o Buzzer A
@@ -63,179 +96,210 @@ uint slice_num_b;  // Slice do PWM para o Buzzer B
 // ----- Instância do display OLED -----
 ssd1306_t display; // Estrutura que representa o display OLED
 
+// ----- Barramento I2C compartilhado (display e futuros sensores) -----
+i2c_bus_t display_bus;                                        // Fila de transações do i2c1
+i2c_dev_t display_dev = { &display_bus, SCREEN_ADDRESS };     // Display no barramento
+
+// ----- Sensor ambiental -----
+i2c_bus_t sensor_bus;   // Fila de transações do i2c0
+bmp280 env_sensor;      // Sensor BMP280
+
 // ----- Variáveis para escalabilidade do jogo -----
 int current_led_count;  // Número de LEDs ativos na rodada atual
 int roundNumber;        // Número da rodada (fase do jogo)
 
-// ----- Prototipação da função para enviar os resultados do jogo para a API -----
-bool send_game_result(int round, int expectedRed, int userRed, int expectedBlue, int userBlue, bool success);
+// ----- Rede -----
+// Com NETWORK_ON_CORE1 o driver Wi‑Fi e o lwIP rodam em modo poll no núcleo 1 e
+// o núcleo 0 só enfileira pedidos; sem ela, rodam em interrupções no núcleo 0.
+#ifndef NETWORK_ON_CORE1
+#define NETWORK_ON_CORE1 0
+#endif
+bool network_ready;     // Módulo Wi‑Fi e lwIP iniciados (a associação segue em segundo plano)
+
+// ----- Prototipação das funções que guardam os resultados do jogo para envio à API -----
+bool send_game_result(int round, int expectedRed, int userRed, int expectedBlue, int userBlue, bool success,
+                      uint64_t startUs, uint64_t endUs);
+void flush_game_results(void);
+void publish_live_event(live_event_type_t type, int expectedRed, int userRed, int expectedBlue, int userBlue, bool success);
 
 // ---------------------------------------------------------------
 // Funções Wi‑Fi e TCP/IP para conexão com o servidor e envio dos dados
 // ---------------------------------------------------------------
 
-// Função para conectar à rede Wi‑Fi e exibir informações no display OLED
-void connect_wifi() {
+// Mudanças do enlace Wi‑Fi (contexto do lwIP): apenas registra; o display é do laço principal
+static void wifi_state_changed(wifi_link_state_t state) {
+    if (state == WIFI_LINK_UP) {
+        uint32_t ip_raw = wifi_link_ip();
+        printf("DEBUG: IP atribuido: %d.%d.%d.%d\n",
+               (int)(ip_raw & 0xFF), (int)((ip_raw >> 8) & 0xFF),
+               (int)((ip_raw >> 16) & 0xFF), (int)((ip_raw >> 24) & 0xFF));
+    } else if (state == WIFI_LINK_DOWN) {
+        printf("DEBUG: WiFi desconectado; resultados ficam no log ate a reconexao\n");
+    }
+}
+
+// Inicia o Wi‑Fi e os clientes da API. Roda no núcleo que atende o lwIP (o 1 com
+// NETWORK_ON_CORE1). Retorna false se o módulo Wi‑Fi (e com ele o lwIP) não iniciou.
+static bool network_setup(void) {
+    if (!wifi_link_start(WIFI_SSID, WIFI_PASSWORD, CYW43_AUTH_WPA2_AES_PSK)) {
+        return false;
+    }
+    wifi_link_set_callback(wifi_state_changed);
+    // Horário UTC das rodadas; a primeira consulta sai assim que o Wi‑Fi conectar
+    net_clock_init(NTP_HOST);
+    // Servidor da API; a conexão keep-alive é aberta no primeiro envio
+    http_client_init(API_HOST, API_PORT);
+#if RESULT_TRANSPORT_UDP
+    telemetry_init(API_HOST, TELEMETRY_PORT);
+#else
+    result_queue_init(API_PATH, RESULT_QUEUE_JSON_ARRAY, API_BATCH_SIZE, API_FLUSH_INTERVAL_MS);
+    result_log_start_forwarding();
+#endif
+    // Painel para espectadores; responde assim que o Wi‑Fi tiver endereço
+    live_server_init(LIVE_SERVER_PORT);
+    return true;
+}
+
+// Função que inicia o Wi‑Fi em segundo plano e exibe o estado no display OLED.
+// Não espera a associação: o jogo começa em seguida e o gerenciador de enlace
+// conecta (e reconecta) sozinho. Retorna false apenas se o módulo Wi‑Fi (e com
+// ele o lwIP) não pôde ser iniciado.
+bool connect_wifi() {
     printf("DEBUG: Inicializando módulo Wi‑Fi...\n");
-    if (cyw43_arch_init()) { // Inicializa o módulo Wi‑Fi; retorna não zero se falhar
+#if NETWORK_ON_CORE1
+    bool started = net_core_start(network_setup);
+#else
+    bool started = network_setup();
+#endif
+    if (!started) {
+        display_service_begin();
         ssd1306_clear(&display);
         ssd1306_draw_string(&display, 0, 0, 1, "Falha ao iniciar WiFi.");
-        ssd1306_show(&display);
+        display_service_show();
         printf("DEBUG: Falha na inicializacao do WiFi.\n");
         sleep_ms(3000);
-        return;
-    }
-    printf("DEBUG: Habilitando modo STA...\n");
-    cyw43_arch_enable_sta_mode(); // Habilita o modo Station (conectar-se a uma rede)
-    printf("DEBUG: Conectando na rede Wi‑Fi: %s\n", WIFI_SSID);
-    // Tenta conectar à rede Wi‑Fi com timeout de 30 segundos
-    if (cyw43_arch_wifi_connect_timeout_ms(WIFI_SSID, WIFI_PASSWORD, CYW43_AUTH_WPA2_AES_PSK, 30000)) {
-        ssd1306_clear(&display);
-        ssd1306_draw_string(&display, 0, 0, 1, "Falha ao conectar WiFi.");
-        ssd1306_show(&display);
-        printf("DEBUG: Falha ao conectar WiFi.\n");
-        sleep_ms(3000);
-    } else {
-        ssd1306_clear(&display);
-        // Exibe mensagem centralizada no display indicando sucesso na conexão
-        int x_centered = (SCREEN_WIDTH - (strlen("Conectado ao WiFi") * 6)) / 2;
-        ssd1306_draw_string(&display, x_centered, 16, 1, "Conectado ao WiFi");
-        printf("DEBUG: Conectado ao Wi‑Fi.\n");
-        // Obtém e exibe o endereço IP
-        ip4_addr_t ip = cyw43_state.netif[0].ip_addr;
-        uint32_t ip_raw = ip4_addr_get_u32(&ip);
-        uint8_t ip_address[4] = {
-            (uint8_t)(ip_raw & 0xFF),
-            (uint8_t)((ip_raw >> 8) & 0xFF),
-            (uint8_t)((ip_raw >> 16) & 0xFF),
-            (uint8_t)((ip_raw >> 24) & 0xFF)
-        };
-        char bufferWifi[50];
-        sprintf(bufferWifi, "IP: %d.%d.%d.%d", ip_address[0], ip_address[1], ip_address[2], ip_address[3]);
-        x_centered = (SCREEN_WIDTH - (strlen(bufferWifi) * 6)) / 2;
-        ssd1306_draw_string(&display, x_centered, 32, 1, bufferWifi);
-        ssd1306_show(&display);
-        printf("DEBUG: IP atribuido: %s\n", bufferWifi);
-        sleep_ms(5000);
+        return false;
     }
+    printf("DEBUG: Conectando na rede Wi‑Fi em segundo plano: %s\n", WIFI_SSID);
+
+    display_service_begin();
+    ssd1306_clear(&display);
+    // Exibe mensagem centralizada no display; a conexão segue durante o jogo
+    int x_centered = (SCREEN_WIDTH - (strlen("Conectando WiFi...") * 6)) / 2;
+    ssd1306_draw_string(&display, x_centered, 16, 1, "Conectando WiFi...");
+    x_centered = (SCREEN_WIDTH - (strlen(WIFI_SSID) * 6)) / 2;
+    ssd1306_draw_string(&display, x_centered, 32, 1, WIFI_SSID);
+    display_service_show();
+    return true;
 }
 
-// Estrutura para manter o estado da conexão HTTP/TCP
-typedef struct {
-    struct tcp_pcb *pcb;      // Estrutura PCB do TCP
-    bool complete;            // Flag para indicar que a resposta foi completamente recebida
-    char request[512];        // Buffer para armazenar a requisição HTTP
-    char response[512];       // Buffer para armazenar a resposta HTTP
-    size_t response_len;      // Tamanho da resposta recebida
-    ip_addr_t remote_addr;    // Endereço IP do servidor remoto
-} HTTP_CLIENT_T;
-
-// Função callback para receber dados via TCP
-static err_t tcp_client_recv(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t err) {
-    HTTP_CLIENT_T *state = (HTTP_CLIENT_T *)arg;
-    if (!p) {  // Se não houver pacote, a transmissão está completa
-        state->complete = true;
-        return ERR_OK;
+// Entrega a rodada ao transporte configurado (no núcleo da rede). No modo HTTP a
+// rodada é gravada no log em flash e repassada em segundo plano à fila de lotes
+// quando houver rede; nada se perde se o Wi‑Fi cair. No modo UDP sai um datagrama por rodada.
+static void store_game_result(const void *data) {
+    const game_round_t *r = (const game_round_t *)data;
+#if RESULT_TRANSPORT_UDP
+    if (!network_ready || !telemetry_send_round(r)) {
+        printf("DEBUG: Telemetria indisponivel; rodada %d descartada\n", r->round);
     }
-    if (p->tot_len > 0) {
-        // Copia os dados recebidos para o buffer de resposta
-        size_t to_copy = (p->tot_len < sizeof(state->response) - state->response_len - 1)
-            ? p->tot_len : sizeof(state->response) - state->response_len - 1;
-        pbuf_copy_partial(p, state->response + state->response_len, to_copy, 0);
-        state->response_len += to_copy;
-        state->response[state->response_len] = '\0';
+#else
+    if (!result_log_append(r)) {
+        // Sem log em flash: a rodada vai direto para a fila (perdida se a placa reiniciar)
+        if (!network_ready || !result_queue_push(r)) {
+            printf("DEBUG: Falha ao gravar a rodada %d no log\n", r->round);
+        }
     }
-    tcp_recved(tpcb, p->tot_len); // Informa ao TCP que os dados foram processados
-    pbuf_free(p);  // Libera o buffer recebido
-    return ERR_OK;
+#endif
 }
 
-// Função callback chamada ao conectar com sucesso ao servidor
-static err_t tcp_client_connected(void *arg, struct tcp_pcb *tpcb, err_t err) {
-    if (err != ERR_OK) {  // Verifica se houve erro na conexão
-        printf("DEBUG: Erro ao conectar: %d\n", err);
-        return err;
-    }
-    HTTP_CLIENT_T *state = (HTTP_CLIENT_T *)arg;
-    // Envia a requisição HTTP para o servidor
-    err = tcp_write(tpcb, state->request, strlen(state->request), TCP_WRITE_FLAG_COPY);
-    if (err != ERR_OK) {
-        printf("DEBUG: Erro ao enviar requisicao: %d\n", err);
-        return err;
+// Fim da partida (no núcleo da rede): grava a página parcial do log, envia o lote
+// pendente e registra o uso de memória do lwIP para dimensionar o perfil (lwipopts.h)
+static void store_flush(const void *data) {
+    result_log_flush();
+    if (network_ready) {
+        result_queue_flush();
+        net_stats_print();
     }
-    err = tcp_output(tpcb); // Garante que os dados sejam enviados
-    return err;
 }
 
-// Função que envia os resultados do jogo para a API via requisição HTTP POST
-bool send_game_result(int round, int expectedRed, int userRed, int expectedBlue, int userBlue, bool success) {
-    // Aloca memória para o estado do cliente HTTP
-    HTTP_CLIENT_T *state = (HTTP_CLIENT_T *)calloc(1, sizeof(HTTP_CLIENT_T));
-    if (!state) {
-        printf("DEBUG: Erro ao alocar memoria\n");
+// Função que guarda o resultado da rodada para envio à API. "startUs" e "endUs" são
+// instantes de time_us_64(), convertidos aqui para UTC pelo relógio sincronizado.
+// Retorna imediatamente; com NETWORK_ON_CORE1 a rodada só é enfileirada para o núcleo 1.
+bool send_game_result(int round, int expectedRed, int userRed, int expectedBlue, int userBlue, bool success,
+                      uint64_t startUs, uint64_t endUs) {
+    game_round_t r = {
+        .round = (uint16_t)round,
+        .expected_red = (uint8_t)expectedRed,
+        .user_red = (uint8_t)userRed,
+        .expected_blue = (uint8_t)expectedBlue,
+        .user_blue = (uint8_t)userBlue,
+        .success = success,
+        .start_us = net_clock_to_unix_us(startUs),
+        .end_us = net_clock_to_unix_us(endUs)
+    };
+#if NETWORK_ON_CORE1
+    if (!net_core_submit(store_game_result, &r, sizeof(r))) {
+        printf("DEBUG: Fila do nucleo de rede cheia; rodada %d descartada\n", round);
         return false;
     }
-    // Cria um JSON com os dados do jogo
-    char json_data[128];
-    snprintf(json_data, sizeof(json_data),
-             "{\"round\": %d, \"expectedRed\": %d, \"userRed\": %d, \"expectedBlue\": %d, \"userBlue\": %d, \"success\": %s}",
-             round, expectedRed, userRed, expectedBlue, userBlue, success ? "true" : "false");
-
-    // Prepara a requisição HTTP POST com os dados JSON
-    snprintf(state->request, sizeof(state->request),
-             "POST %s HTTP/1.1\r\n"
-             "Host: %s\r\n"
-             "Content-Type: application/json\r\n"
-             "Content-Length: %d\r\n"
-             "Connection: close\r\n"
-             "\r\n"
-             "%s",
-             API_PATH, API_HOST, (int)strlen(json_data), json_data);
-
-    printf("DEBUG: Enviando JSON para API...\n%s\n", state->request);
-
-    // Resolve o endereço IP do servidor
-    if (!ipaddr_aton(API_HOST, &state->remote_addr)) {
-        printf("DEBUG: Erro ao resolver IP\n");
-        free(state);
-        return false;
-    }
-    // Cria uma nova PCB TCP
-    state->pcb = tcp_new();
-    if (!state->pcb) {
-        printf("DEBUG: Erro ao criar PCB TCP\n");
-        free(state);
-        return false;
-    }
-    tcp_arg(state->pcb, state);
-    tcp_recv(state->pcb, tcp_client_recv);
-    // Conecta ao servidor na porta definida
-    err_t err = tcp_connect(state->pcb, &state->remote_addr, API_PORT, tcp_client_connected);
-    if (err != ERR_OK) {
-        printf("DEBUG: Erro ao conectar ao servidor: %d\n", err);
-        free(state);
-        return false;
-    }
-    // Aguarda um tempo para que a resposta seja recebida (ajustável conforme necessidade)
-    sleep_ms(5000);
-    printf("DEBUG: Resposta da API: %s\n", state->response);
-    free(state);
+#else
+    store_game_result(&r);
+#endif
     return true;
 }
 
+// Função chamada no fim da partida para enviar as rodadas pendentes
+void flush_game_results(void) {
+#if NETWORK_ON_CORE1
+    net_core_submit(store_flush, NULL, 0);
+#else
+    store_flush(NULL);
+#endif
+}
+
+// Evento da partida para os espectadores (no núcleo da rede)
+static void store_live_event(const void *data) {
+    live_server_publish((const live_event_t *)data);
+}
+
+// Função que publica um evento da rodada atual no servidor ao vivo. Retorna
+// imediatamente; com NETWORK_ON_CORE1 o evento só é enfileirado para o núcleo 1.
+void publish_live_event(live_event_type_t type, int expectedRed, int userRed, int expectedBlue, int userBlue, bool success) {
+    if (!network_ready) {
+        return;
+    }
+    live_event_t ev = {
+        .type = (uint8_t)type,
+        .leds = (uint8_t)current_led_count,
+        .round = (uint16_t)roundNumber,
+        .expected_red = (uint8_t)expectedRed,
+        .expected_blue = (uint8_t)expectedBlue,
+        .user_red = (uint8_t)userRed,
+        .user_blue = (uint8_t)userBlue,
+        .success = success,
+        .time_ms = to_ms_since_boot(get_absolute_time())
+    };
+#if NETWORK_ON_CORE1
+    net_core_submit(store_live_event, &ev, sizeof(ev));
+#else
+    store_live_event(&ev);
+#endif
+}
+
 // ---------------------------------------------------------------
 // Funções do jogo: exibição, geração de padrões e lógica
 // ---------------------------------------------------------------
 
 // Função para exibir uma mensagem simples no display OLED com duas linhas
 void display_message(const char *line1, const char *line2) {
+    display_service_begin();
     ssd1306_clear(&display);  // Limpa o display
     // Calcula a posição central para as mensagens
     int16_t x1 = (SCREEN_WIDTH - strlen(line1) * 6) / 2;
     int16_t x2 = (SCREEN_WIDTH - strlen(line2) * 6) / 2;
     ssd1306_draw_string(&display, x1, 20, 1, line1);
     ssd1306_draw_string(&display, x2, 40, 1, line2);
-    ssd1306_show(&display);
+    display_service_show();
     sleep_ms(1500);  // Aguarda 1,5 segundos para que a mensagem seja lida
 }
 
@@ -287,8 +351,19 @@ void buzzer_beep(uint slice_num, int duration_ms) {
     pwm_set_enabled(slice_num, false); // Desliga o PWM (desativa o buzzer)
 }
 
+// Consome as janelas do BMP280 acumuladas desde a última chamada e as registra no serial
+static void log_environment(void) {
+    env_window_t w;
+    while (env_sampler_read(&w)) {
+        printf("DEBUG: Ambiente %.2f C (%.2f a %.2f), %.0f Pa, %u amostras\n",
+               w.temperature_mean / 100.0, w.temperature_min / 100.0, w.temperature_max / 100.0,
+               w.pressure_mean / 256.0, w.count);
+    }
+}
+
 // Função que exibe a tela inicial e aguarda o pressionamento do botão A para iniciar o jogo
 void show_initial_menu() {
+    display_service_begin();
     ssd1306_clear(&display);  // Limpa o display
     // Calcula a posição central para o título do jogo
     int x_center = (SCREEN_WIDTH - strlen("LedReflex Game") * 6) / 2;
@@ -296,11 +371,25 @@ void show_initial_menu() {
     // Exibe instrução para iniciar o jogo
     x_center = (SCREEN_WIDTH - strlen("aperte A para iniciar")) / 2;
     ssd1306_draw_string(&display, 15, 40, 1, "press A to start");
-    ssd1306_show(&display);
+    display_service_show();
+
+    // O título (linhas 20 a 27, páginas 2 e 3) rola pelo próprio controlador do display:
+    // o quadro é enviado uma única vez e o barramento I2C fica livre durante a espera
+    display_service_begin();
+    display_service_flush_now();
+    ssd1306_scroll_horizontal(&display, SSD1306_SCROLL_LEFT, 2, 3, SSD1306_SCROLL_5_FRAMES);
+    display_service_end();
+
     // Loop que aguarda até o botão A ser pressionado (estado ativo baixo)
     while (gpio_get(BUTTON_A_PIN)) {
+        log_environment();
         sleep_ms(100);
     }
+
+    // Após parar a rolagem o conteúdo exibido é indefinido; a próxima tela redesenha tudo
+    display_service_begin();
+    ssd1306_scroll_stop(&display);
+    display_service_end();
     sleep_ms(200); // Delay para debounce
 }
 
@@ -323,12 +412,36 @@ int main() {
         printf("DEBUG: Falha ao inicializar o display SSD1306\n");
         while (1) { tight_loop_contents(); }
     } else {
+        // A partir daqui o framebuffer é enviado pelo serviço de display, por DMA quando disponível
+        bool bus_async = i2c_bus_init(&display_bus, i2c1, true);
+        if (!bus_async) {
+            i2c_bus_init(&display_bus, i2c1, false);
+        }
+        display_service_init(&display, bus_async ? &display_dev : NULL, DISPLAY_MAX_FPS);
+        display_service_begin();
         ssd1306_clear(&display);
         ssd1306_draw_string(&display, 0, 0, 1, "Iniciando Jogo...");
-        ssd1306_show(&display);
+        display_service_show();
         sleep_ms(150);
     }
 
+    // Inicializa o BMP280 no i2c0 e a amostragem em segundo plano; sem o sensor o jogo segue normalmente
+    printf("DEBUG: Inicializando sensor BMP280...\n");
+    i2c_init(i2c0, 400 * 1000);
+    gpio_set_function(SENSOR_I2C_SDA, GPIO_FUNC_I2C);
+    gpio_set_function(SENSOR_I2C_SCL, GPIO_FUNC_I2C);
+    gpio_pull_up(SENSOR_I2C_SDA);
+    gpio_pull_up(SENSOR_I2C_SCL);
+    bool sensor_bus_async = i2c_bus_init(&sensor_bus, i2c0, true);
+    bmp280_i2c_init(&env_sensor, &sensor_bus, BMP280_I2C_ADDRESS);
+    if (sensor_bus_async && bmp280_i2c_setup(&env_sensor) > 0) {
+        bmp280_i2c_calibrate(&env_sensor);
+        bmp280_i2c_set_profile(&env_sensor, BMP280_PROFILE_LOW_POWER);
+        env_sampler_start(&env_sensor, ENV_SAMPLE_RATE_HZ, ENV_DECIMATION);
+    } else {
+        printf("DEBUG: BMP280 nao encontrado, amostragem desativada\n");
+    }
+
     // Inicializa a matriz de LEDs WS2812B
     printf("DEBUG: Inicializando matriz de LEDs (WS2812B)...\n");
     ws2812b_set_global_dimming(7);
@@ -352,20 +465,21 @@ int main() {
     // Inicializa a semente do gerador de números aleatórios com base no tempo de boot
     srand(to_ms_since_boot(get_absolute_time()));
 
+    // Retoma o log em flash: rodadas de partidas anteriores sem confirmação serão reenviadas
+    result_log_init();
+
     // Conecta ao Wi‑Fi e exibe informações no display
     printf("DEBUG: Chamando função connect_wifi()...\n");
-    connect_wifi();
+    network_ready = connect_wifi();
 
     // Animação de "cortina" no display OLED para transição
     int curtain_position = SCREEN_HEIGHT;
     while (curtain_position >= 0) {
+        display_service_begin();
         ssd1306_clear(&display);
-        for (int x = 0; x < SCREEN_WIDTH; x++) {
-            for (int y = 0; y < curtain_position; y++) {
-                ssd1306_draw_pixel(&display, x, y);  // Preenche os pixels até a posição da cortina
-            }
-        }
-        ssd1306_show(&display);
+        // Preenche a área até a posição da cortina (preenchimento por páginas inteiras)
+        ssd1306_draw_square(&display, 0, 0, SCREEN_WIDTH, curtain_position);
+        display_service_show();
         curtain_position -= 2;
         sleep_ms(50);
     }
@@ -378,9 +492,12 @@ int main() {
         // Reinicia os parâmetros do jogo: rodada começa na 1 e 5 LEDs ativos
         roundNumber = 1;
         current_led_count = 5;
+        publish_live_event(LIVE_EVENT_GAME_START, 0, 0, 0, 0, false);
         
         // Loop de rodadas do jogo
         while (true) {
+            log_environment();  // Uma vez por rodada: o buffer guarda ENV_SAMPLER_RING_SIZE segundos
+
             // Calcula o tempo de exibição do padrão e o tempo de resposta com base na rodada atual
             int patternDisplayTime = (int)(INITIAL_PATTERN_TIME * pow(1.1, roundNumber));
             int responseTime = (int)(INITIAL_RESPONSE_TIME * pow(1.01, roundNumber));
@@ -392,8 +509,10 @@ int main() {
 
             // Exibe o padrão de LEDs na matriz
             show_led_pattern(pattern);
+            publish_live_event(LIVE_EVENT_ROUND_START, expectedRed, 0, expectedBlue, 0, false);
 
             // Exibe instruções no display OLED para o jogador contar as cores
+            display_service_begin();
             ssd1306_clear(&display);
             ssd1306_draw_string(&display, 0, 0, 1, "Conte as cores!");
             char instr[32];
@@ -403,7 +522,9 @@ int main() {
             ssd1306_draw_string(&display, 0, 32, 1, instr);
             sprintf(instr, "B p/ Azul");
             ssd1306_draw_string(&display, 0, 48, 1, instr);
-            ssd1306_show(&display);
+            display_service_show();
+            display_service_flush_now();  // O tempo de exibição do padrão começa agora
+            uint64_t roundStartUs = time_us_64();
 
             // Aguarda o tempo definido para exibir o padrão
             sleep_ms(patternDisplayTime);
@@ -415,71 +536,94 @@ int main() {
             // Variáveis para contar os pressionamentos do usuário
             int userRedPresses = 0;
             int userBluePresses = 0;
+
+            // Tela de contagem: cada pressionamento redesenha e envia apenas os dígitos alterados
+            ssd1306_widget_t count_widgets[2];
+            ssd1306_widget_counter(&count_widgets[0], 0, 0, 1, "Vermelho: ", 0);
+            ssd1306_widget_counter(&count_widgets[1], 0, 16, 1, "Azul: ", 0);
+            ssd1306_screen_t count_screen;
+            ssd1306_screen_init(&count_screen, &display, count_widgets, 2);
+            count_screen.flush = display_service_flush_region;  // Regiões alteradas são enviadas pelo serviço
+            bool count_screen_shown = false;  // A tela de instruções permanece até o primeiro pressionamento
             uint64_t startTime = to_ms_since_boot(get_absolute_time());
             // Loop para capturar os pressionamentos dos botões dentro do tempo de resposta
             while (to_ms_since_boot(get_absolute_time()) - startTime < responseTime) {
                 if (!gpio_get(BUTTON_A_PIN)) { // Botão A pressionado
-                    ssd1306_clear(&display);
                     userRedPresses++;
-                    char countMsgv[32], countMsgb[32];
-                    sprintf(countMsgv, "Vermelho: %d", userRedPresses);
-                    ssd1306_draw_string(&display, 0, 0, 1, countMsgv);
-                    sprintf(countMsgb, "Azul: %d", userBluePresses);
-                    ssd1306_draw_string(&display, 0, 16, 1, countMsgb);
-                    ssd1306_show(&display);
+                    publish_live_event(LIVE_EVENT_PRESS, expectedRed, userRedPresses, expectedBlue, userBluePresses, false);
+                    ssd1306_widget_set_value(&count_widgets[0], userRedPresses);
+                    display_service_begin();
+                    if (count_screen_shown) {
+                        ssd1306_screen_update(&count_screen);
+                    } else {
+                        ssd1306_screen_show(&count_screen);
+                        count_screen_shown = true;
+                    }
+                    display_service_end();
                     sleep_ms(200);  // Debounce e evita múltiplos registros indesejados
                 }
                 if (!gpio_get(BUTTON_B_PIN)) { // Botão B pressionado
-                    ssd1306_clear(&display);
                     userBluePresses++;
-                    char countMsgv[32], countMsgb[32];
-                    sprintf(countMsgv, "Vermelho: %d", userRedPresses);
-                    ssd1306_draw_string(&display, 0, 0, 1, countMsgv);
-                    sprintf(countMsgb, "Azul: %d", userBluePresses);
-                    ssd1306_draw_string(&display, 0, 16, 1, countMsgb);
-                    ssd1306_show(&display);
+                    publish_live_event(LIVE_EVENT_PRESS, expectedRed, userRedPresses, expectedBlue, userBluePresses, false);
+                    ssd1306_widget_set_value(&count_widgets[1], userBluePresses);
+                    display_service_begin();
+                    if (count_screen_shown) {
+                        ssd1306_screen_update(&count_screen);
+                    } else {
+                        ssd1306_screen_show(&count_screen);
+                        count_screen_shown = true;
+                    }
+                    display_service_end();
                     sleep_ms(200);
                 }
             }
+            uint64_t roundEndUs = time_us_64();  // Fim do tempo de resposta
 
             // Após o período de resposta, verifica se o jogador acertou a contagem
-            ssd1306_clear(&display);
             char result[32] = "";
             char result2[32] = "";
             bool success = false;
             if (userRedPresses == expectedRed && userBluePresses == expectedBlue) {
                 // Caso a contagem esteja correta
+                publish_live_event(LIVE_EVENT_RESULT, expectedRed, userRedPresses, expectedBlue, userBluePresses, true);
                 sprintf(result, "Acertou!");
                 // Emite beep curto em ambos os buzzers
                 buzzer_beep(slice_num_a, 100);
                 buzzer_beep(slice_num_b, 100);
                 success = true;
-                send_game_result(roundNumber, expectedRed, userRedPresses, expectedBlue, userBluePresses, success);
+                send_game_result(roundNumber, expectedRed, userRedPresses, expectedBlue, userBluePresses, success,
+                                 roundStartUs, roundEndUs);
                 roundNumber++;  // Avança para a próxima rodada
                 if (current_led_count < NUM_LEDS) {
                     current_led_count++;  // Aumenta a quantidade de LEDs ativos para aumentar a dificuldade
                 }
             } else {
                 // Se a contagem estiver incorreta, indica erro
+                publish_live_event(LIVE_EVENT_RESULT, expectedRed, userRedPresses, expectedBlue, userBluePresses, false);
                 sprintf(result, "Voce errou!");
                 sprintf(result2, "Fase: %d", roundNumber);
                 // Emite beep longo em ambos os buzzers
                 buzzer_beep(slice_num_a, 300);
                 buzzer_beep(slice_num_b, 300);
-                send_game_result(roundNumber, expectedRed, userRedPresses, expectedBlue, userBluePresses, success);
+                send_game_result(roundNumber, expectedRed, userRedPresses, expectedBlue, userBluePresses, success,
+                                 roundStartUs, roundEndUs);
+                flush_game_results();  // Fim da partida: envia as rodadas pendentes
                 // Exibe mensagem de erro e fase atingida
+                display_service_begin();
+                ssd1306_clear(&display);
                 ssd1306_draw_string(&display, 0, 0, 1, result);
                 ssd1306_draw_string(&display, 0, 16, 1, result2);
                 ssd1306_draw_string(&display, 0, 32, 1, "Encerrando...");
-                ssd1306_show(&display);
+                display_service_show();
                 sleep_ms(3000);
                 // Encerra a partida, retornando à tela inicial
                 break;
             }
             
             // Limpa o display entre as rodadas
+            display_service_begin();
             ssd1306_clear(&display);
-            ssd1306_show(&display);
+            display_service_show();
         }
     }
 
@@ -0,0 +1,205 @@
+#include "display_service.h"
+
+#include "pico/stdlib.h"      // Timers repetitivos (repeating_timer_t)
+#include "hardware/sync.h"    // save_and_disable_interrupts()
+
+// Máximo de páginas do display (64 linhas), uma transação por página nos envios parciais
+#define DISPLAY_SERVICE_MAX_PAGES 8
+
+// ----- Estado do serviço -----
+static ssd1306_t *service_disp;             // Display atendido pelo serviço
+static const i2c_dev_t *service_dev;        // Dispositivo no barramento compartilhado (NULL = envio bloqueante)
+static repeating_timer_t service_timer;     // Timer que dispara os envios
+static volatile int drawing_depth;          // > 0 enquanto o framebuffer está sendo desenhado ou enviado
+static volatile bool dirty;                 // Existe região pendente de envio
+// Região pendente (união das regiões marcadas), limites finais exclusivos
+static volatile uint32_t dirty_x0, dirty_y0, dirty_x1, dirty_y1;
+
+// ----- Envio assíncrono -----
+static i2c_xfer_t frame_xfers[DISPLAY_SERVICE_MAX_PAGES];                           // Descritores das transações
+static uint8_t frame_headers[DISPLAY_SERVICE_MAX_PAGES][SSD1306_ADDR_HEADER_SIZE];  // Cabeçalhos de endereçamento
+static volatile uint32_t frames_in_flight;                                          // Transações ainda não concluídas
+
+// Escrita bloqueante usada pelo driver (comandos, rolagem) através do barramento compartilhado
+static int display_service_write(void *ctx, const uint8_t *src, size_t len) {
+    return i2c_dev_write_blocking((const i2c_dev_t *)ctx, src, len);
+}
+
+// Desconta transações concluídas ou recusadas. O contador também é alterado no
+// contexto do programa e no timer: toda alteração é feita com interrupções desligadas.
+static void display_service_uncount(uint32_t n) {
+    uint32_t irq = save_and_disable_interrupts();
+    frames_in_flight -= n;
+    restore_interrupts(irq);
+}
+
+// Conclusão de uma transação (normalmente na interrupção do barramento)
+static void display_service_xfer_done(i2c_xfer_t *xfer, int result) {
+    display_service_uncount(1);
+}
+
+// Enfileira uma janela do framebuffer: cabeçalho como prefixo, dados direto do buffer.
+// A transação já deve estar contada em frames_in_flight.
+static void display_service_submit(uint32_t x0, uint32_t x1, uint32_t page_start, uint32_t page_end, uint32_t slot) {
+    i2c_xfer_t *xfer = &frame_xfers[slot];
+    ssd1306_window_header(service_disp, frame_headers[slot], x0, x1 - 1, page_start, page_end);
+
+    xfer->dev = service_dev;
+    xfer->prefix = frame_headers[slot];
+    xfer->prefix_len = SSD1306_ADDR_HEADER_SIZE;
+    xfer->tx = service_disp->buffer + page_start * service_disp->width + x0;
+    xfer->tx_len = (page_end - page_start) * service_disp->width + (x1 - x0);
+    xfer->rx = NULL;
+    xfer->rx_len = 0;
+    xfer->prio = I2C_BUS_PRIO_LOW;
+    xfer->done = display_service_xfer_done;
+
+    if (!i2c_bus_submit(xfer)) {
+        display_service_uncount(1);
+    }
+}
+
+// Enfileira a região pendente sem esperar; largura total vira uma única transação,
+// regiões parciais uma transação por página (as linhas não são contíguas no buffer)
+static void display_service_submit_region(uint32_t x0, uint32_t y0, uint32_t x1, uint32_t y1) {
+    uint32_t page_start = y0 / 8;
+    uint32_t page_end = (y1 - 1) / 8;
+    bool full_width = x0 == 0 && x1 == service_disp->width;
+
+    // O lote inteiro é contado antes do primeiro envio: as primeiras páginas podem
+    // terminar (e descontar na interrupção) enquanto as seguintes são enfileiradas
+    uint32_t irq = save_and_disable_interrupts();
+    frames_in_flight += full_width ? 1 : page_end - page_start + 1;
+    restore_interrupts(irq);
+
+    if (full_width) {
+        display_service_submit(x0, x1, page_start, page_end, 0);
+        return;
+    }
+    for (uint32_t page = page_start; page <= page_end; page++) {
+        display_service_submit(x0, x1, page, page, page - page_start);
+    }
+}
+
+// Envia a região pendente; chamado pelo timer (envio assíncrono), por
+// display_service_end() (envio bloqueante) ou por display_service_flush_now()
+static void display_service_flush_pending(void) {
+    // Copia e zera a região pendente sem que o timer interrompa a leitura
+    uint32_t irq = save_and_disable_interrupts();
+    bool pending = dirty;
+    uint32_t x0 = dirty_x0, y0 = dirty_y0, x1 = dirty_x1, y1 = dirty_y1;
+    dirty = false;
+    restore_interrupts(irq);
+
+    if (!pending) {
+        return;
+    }
+    // Limita a região ao display antes de montar as transações
+    if (x1 > service_disp->width) x1 = service_disp->width;
+    if (y1 > service_disp->height) y1 = service_disp->height;
+    if (x0 >= x1 || y0 >= y1) {
+        return;
+    }
+    if (service_dev) {
+        display_service_submit_region(x0, y0, x1, y1);
+    } else if (x0 == 0 && y0 == 0 && x1 >= service_disp->width && y1 >= service_disp->height) {
+        ssd1306_show(service_disp);
+    } else {
+        ssd1306_show_region(service_disp, x0, y0, x1 - x0, y1 - y0);
+    }
+}
+
+// Callback do timer (apenas com envio assíncrono): envia no máximo um quadro por
+// intervalo, nunca no meio de um desenho nem antes de o quadro anterior terminar
+// de sair pelo barramento
+static bool display_service_timer_cb(repeating_timer_t *t) {
+    if (drawing_depth == 0 && frames_in_flight == 0) {
+        display_service_flush_pending();
+    }
+    return true;  // Mantém o timer ativo
+}
+
+bool display_service_init(ssd1306_t *disp, const i2c_dev_t *dev, uint32_t max_fps) {
+    service_disp = disp;
+    service_dev = dev;
+    drawing_depth = 0;
+    dirty = false;
+    frames_in_flight = 0;
+    if (dev) {
+        // Comandos do driver passam a usar a mesma fila dos quadros
+        ssd1306_set_write_fn(disp, display_service_write, (void *)dev);
+    }
+    if (!dev) {
+        // Envio bloqueante (~25 ms por quadro a 400 kHz) não pode rodar na interrupção
+        // do alarme, que atrasaria sleep_ms() e a amostragem do sensor: fica com
+        // display_service_end(), no contexto do programa
+        return true;
+    }
+    if (max_fps == 0) {
+        max_fps = DISPLAY_SERVICE_DEFAULT_FPS;
+    }
+    // Período negativo: intervalo medido entre o início de cada chamada
+    return add_repeating_timer_ms(-(int32_t)(1000 / max_fps), display_service_timer_cb, NULL, &service_timer);
+}
+
+void display_service_begin(void) {
+    drawing_depth++;  // A partir daqui o timer não enfileira quadros novos
+    // Quadros já enfileirados são lidos do framebuffer pelo DMA: redesenhar antes
+    // de terminarem rasgaria a imagem em envio
+    while (frames_in_flight) {
+        tight_loop_contents();
+    }
+}
+
+void display_service_end(void) {
+    if (drawing_depth > 0) {
+        drawing_depth--;
+    }
+    if (!service_dev && drawing_depth == 0) {
+        display_service_flush_pending();
+    }
+}
+
+void display_service_show(void) {
+    display_service_mark_region(0, 0, service_disp->width, service_disp->height);
+    display_service_end();
+}
+
+void display_service_mark_region(uint32_t x, uint32_t y, uint32_t width, uint32_t height) {
+    if (!width || !height) {
+        return;
+    }
+    uint32_t x1 = x + width, y1 = y + height;
+    uint32_t irq = save_and_disable_interrupts();
+    if (!dirty) {
+        dirty_x0 = x;
+        dirty_y0 = y;
+        dirty_x1 = x1;
+        dirty_y1 = y1;
+        dirty = true;
+    } else {
+        // Une a nova região à pendente
+        if (x < dirty_x0) dirty_x0 = x;
+        if (y < dirty_y0) dirty_y0 = y;
+        if (x1 > dirty_x1) dirty_x1 = x1;
+        if (y1 > dirty_y1) dirty_y1 = y1;
+    }
+    restore_interrupts(irq);
+}
+
+void display_service_flush_region(ssd1306_t *disp, uint32_t x, uint32_t y, uint32_t width, uint32_t height) {
+    display_service_mark_region(x, y, width, height);
+}
+
+void display_service_flush_now(void) {
+    drawing_depth++;  // Impede que o timer envie ao mesmo tempo
+    // Um quadro anterior ainda em andamento usa os mesmos descritores
+    while (frames_in_flight) {
+        tight_loop_contents();
+    }
+    display_service_flush_pending();
+    while (frames_in_flight) {
+        tight_loop_contents();
+    }
+    drawing_depth--;
+}
@@ -0,0 +1,40 @@
+#ifndef DISPLAY_SERVICE_H
+#define DISPLAY_SERVICE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ssd1306.h"
+#include "i2c_bus.h"
+
+// Taxa máxima padrão de atualização do display OLED (quadros por segundo)
+#define DISPLAY_SERVICE_DEFAULT_FPS 30
+
+// Inicia o serviço de atualização do display: um timer envia o framebuffer
+// no máximo "max_fps" vezes por segundo, apenas quando houver alterações.
+// Com "dev" (display em um i2c_bus_t) os quadros são enfileirados com prioridade
+// baixa e enviados por DMA, sem bloquear o timer. Com NULL o envio é bloqueante
+// e acontece em display_service_end(), fora de interrupções; o próprio envio
+// limita a taxa e "max_fps" não é usado.
+bool display_service_init(ssd1306_t *disp, const i2c_dev_t *dev, uint32_t max_fps);
+
+// Marca o início de um desenho no framebuffer; nenhum envio acontece até display_service_end()
+void display_service_begin(void);
+
+// Marca o fim do desenho; as regiões marcadas serão enviadas no próximo intervalo
+// (ou agora, com envio bloqueante, ao fechar o desenho mais externo)
+void display_service_end(void);
+
+// Marca o quadro inteiro como alterado e encerra o desenho (substitui ssd1306_show())
+void display_service_show(void);
+
+// Marca apenas uma região do framebuffer como alterada
+void display_service_mark_region(uint32_t x, uint32_t y, uint32_t width, uint32_t height);
+
+// Compatível com ssd1306_flush_fn, para uso em ssd1306_screen_t
+void display_service_flush_region(ssd1306_t *disp, uint32_t x, uint32_t y, uint32_t width, uint32_t height);
+
+// Envia imediatamente as alterações pendentes e aguarda o fim da transferência
+// (para casos sensíveis à latência)
+void display_service_flush_now(void);
+
+#endif // DISPLAY_SERVICE_H
@@ -0,0 +1,163 @@
+#include "env_sampler.h"
+
+#include "pico/stdlib.h"      // Timers repetitivos e time_us_64()
+#include "hardware/sync.h"    // __dmb()
+
+// ----- Estado do amostrador -----
+static bmp280 *sampler_device;            // Sensor amostrado
+static repeating_timer_t sampler_timer;   // Timer que dispara as conversões
+static bool sampler_running;
+static uint32_t sampler_decimation;       // Amostras por janela
+
+// Janela em construção (acessada apenas no callback do sensor)
+static env_window_t acc;
+static int64_t acc_temperature_sum;
+static uint64_t acc_pressure_sum;
+
+// ----- Buffer circular sem trava -----
+// Um único produtor (interrupção) avança "ring_head" e um único consumidor
+// avança "ring_tail"; os contadores crescem livremente e o índice é o resto.
+static env_window_t ring[ENV_SAMPLER_RING_SIZE];
+static volatile uint32_t ring_head;
+static volatile uint32_t ring_tail;
+
+// ----- Janela mais recente -----
+// Atualizada a cada janela, mesmo com o buffer cheio ou sem consumidor.
+// "latest_seq" fica ímpar enquanto o produtor escreve; o leitor repete a cópia
+// se a sequência mudou no meio.
+static env_window_t latest;
+static volatile uint32_t latest_seq;
+
+// ----- Diagnóstico -----
+static volatile uint32_t dropped_windows;
+static volatile uint32_t missed_triggers;
+static volatile uint32_t read_errors;
+
+static void env_sampler_reset_window(void) {
+    acc.count = 0;
+    acc_temperature_sum = 0;
+    acc_pressure_sum = 0;
+}
+
+// Publica a janela acumulada como a mais recente e no buffer; se o buffer
+// estiver cheio a janela só fica disponível em env_sampler_latest()
+static void env_sampler_publish(void) {
+    env_window_t w = acc;
+    w.temperature_mean = (int32_t)(acc_temperature_sum / acc.count);
+    w.pressure_mean = (uint32_t)(acc_pressure_sum / acc.count);
+
+    latest_seq++;
+    __dmb();
+    latest = w;
+    __dmb();
+    latest_seq++;
+
+    uint32_t head = ring_head;
+    if (head - ring_tail >= ENV_SAMPLER_RING_SIZE) {
+        dropped_windows++;
+        return;
+    }
+    ring[head % ENV_SAMPLER_RING_SIZE] = w;
+    __dmb();  // A janela precisa estar completa antes de o consumidor ver o novo head
+    ring_head = head + 1;
+}
+
+// Callback do sensor (contexto de interrupção): agrega a amostra na janela atual
+static void env_sampler_sample_done(bmp280 *device, int result) {
+    if (result < 0) {
+        read_errors++;
+        return;
+    }
+
+    int32_t t = device->temperature_int;
+    uint32_t p = device->pressure_int;
+    if (acc.count == 0) {
+        acc.temperature_min = acc.temperature_max = t;
+        acc.pressure_min = acc.pressure_max = p;
+    } else {
+        if (t < acc.temperature_min) acc.temperature_min = t;
+        if (t > acc.temperature_max) acc.temperature_max = t;
+        if (p < acc.pressure_min) acc.pressure_min = p;
+        if (p > acc.pressure_max) acc.pressure_max = p;
+    }
+    acc_temperature_sum += t;
+    acc_pressure_sum += p;
+    acc.count++;
+    acc.timestamp_us = time_us_64();
+
+    if (acc.count >= sampler_decimation) {
+        env_sampler_publish();
+        env_sampler_reset_window();
+    }
+}
+
+// Callback do timer: dispara uma conversão em modo forçado, sem esperar o resultado
+static bool env_sampler_timer_cb(repeating_timer_t *t) {
+    if (!bmp280_sample_async(sampler_device, env_sampler_sample_done)) {
+        missed_triggers++;  // Taxa maior que o tempo de medição do perfil atual
+    }
+    return sampler_running;
+}
+
+bool env_sampler_start(bmp280 *device, uint32_t rate_hz, uint32_t decimation) {
+    if (sampler_running || rate_hz == 0) {
+        return false;
+    }
+    sampler_device = device;
+    sampler_decimation = decimation ? decimation : 1;
+    env_sampler_reset_window();
+
+    sampler_running = true;
+    // Período negativo: intervalo medido entre o início de cada chamada
+    if (!add_repeating_timer_us(-(int64_t)(1000000 / rate_hz), env_sampler_timer_cb, NULL, &sampler_timer)) {
+        sampler_running = false;
+        return false;
+    }
+    return true;
+}
+
+void env_sampler_stop(void) {
+    if (sampler_running) {
+        sampler_running = false;
+        cancel_repeating_timer(&sampler_timer);
+    }
+}
+
+bool env_sampler_read(env_window_t *out) {
+    uint32_t tail = ring_tail;
+    if (ring_head == tail) {
+        return false;
+    }
+    __dmb();  // Lê a janela somente depois de observar o head que a publicou
+    *out = ring[tail % ENV_SAMPLER_RING_SIZE];
+    __dmb();
+    ring_tail = tail + 1;
+    return true;
+}
+
+bool env_sampler_latest(env_window_t *out) {
+    uint32_t seq;
+    do {
+        seq = latest_seq;
+        __dmb();
+        *out = latest;
+        __dmb();
+    } while ((seq & 1) || seq != latest_seq);
+    return seq != 0;
+}
+
+uint32_t env_sampler_available(void) {
+    return ring_head - ring_tail;
+}
+
+uint32_t env_sampler_dropped(void) {
+    return dropped_windows;
+}
+
+uint32_t env_sampler_missed(void) {
+    return missed_triggers;
+}
+
+uint32_t env_sampler_errors(void) {
+    return read_errors;
+}
@@ -0,0 +1,48 @@
+#ifndef ENV_SAMPLER_H
+#define ENV_SAMPLER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "bmp280_driver.h"
+
+// Janelas agregadas guardadas no buffer circular (potência de 2)
+#define ENV_SAMPLER_RING_SIZE 32
+
+// Janela de amostras agregadas (média, mínimo e máximo)
+typedef struct {
+    uint64_t timestamp_us;        // Instante da última amostra da janela (time_us_64)
+    uint16_t count;               // Amostras válidas na janela
+    int32_t temperature_mean;     // Temperatura em 0,01 °C
+    int32_t temperature_min;
+    int32_t temperature_max;
+    uint32_t pressure_mean;       // Pressão em Pa no formato Q24.8 (dividir por 256)
+    uint32_t pressure_min;
+    uint32_t pressure_max;
+} env_window_t;
+
+// Inicia a amostragem em segundo plano: um timer dispara uma conversão do
+// BMP280 "rate_hz" vezes por segundo e cada "decimation" amostras viram uma
+// janela no buffer circular. O sensor deve estar em um i2c_bus_t assíncrono.
+bool env_sampler_start(bmp280 *device, uint32_t rate_hz, uint32_t decimation);
+
+// Interrompe a amostragem; janelas já armazenadas continuam disponíveis
+void env_sampler_stop(void);
+
+// Retira a janela mais antiga do buffer; retorna false se estiver vazio.
+// Com o buffer cheio as janelas novas são descartadas até haver leitura.
+bool env_sampler_read(env_window_t *out);
+
+// Consulta a janela mais recente, mesmo que o buffer esteja cheio ou não seja
+// lido; retorna false se nenhuma janela foi concluída
+bool env_sampler_latest(env_window_t *out);
+
+// Janelas prontas para leitura
+uint32_t env_sampler_available(void);
+
+// Contadores de diagnóstico: janelas descartadas (buffer cheio), disparos
+// perdidos (conversão anterior ainda em andamento) e erros de leitura
+uint32_t env_sampler_dropped(void);
+uint32_t env_sampler_missed(void);
+uint32_t env_sampler_errors(void);
+
+#endif // ENV_SAMPLER_H
@@ -0,0 +1,502 @@
+#include "http_client.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#include "pico/cyw43_arch.h"  // cyw43_arch_lwip_begin()/end()
+#include "lwip/tcp.h"         // API "raw" de TCP do lwIP
+#include "lwip/timeouts.h"    // sys_timeout()/sys_untimeout()
+#include "lwip/dns.h"         // Resolução do nome do servidor
+
+// Requisição na fila: enviada em ordem, respondida em ordem (HTTP/1.1 pipelining)
+typedef struct {
+    char request[HTTP_CLIENT_REQUEST_SIZE];   // Requisição HTTP completa
+    size_t len;
+    size_t written;                           // Bytes já entregues ao TCP nesta conexão
+    uint8_t attempts;                         // Conexões em que a requisição começou a ser enviada
+    http_client_done_fn done;                 // Callback de conclusão
+    void *arg;
+} http_request_t;
+
+// Etapas da leitura de uma resposta
+typedef enum {
+    HTTP_RESPONSE_HEADER = 0,     // Lendo o cabeçalho até "\r\n\r\n"
+    HTTP_RESPONSE_BODY,           // Lendo Content-Length bytes de corpo
+    HTTP_RESPONSE_UNTIL_CLOSE     // Sem Content-Length: o corpo termina quando o servidor fecha
+} http_response_state_t;
+
+// Estado do cliente. É estático: os callbacks do lwIP podem chegar depois do
+// retorno de http_client_post_json() e nunca encontram memória liberada.
+typedef struct {
+    char host[64];                            // Servidor das requisições
+    uint16_t port;
+    ip_addr_t remote_addr;
+    bool resolved;                            // remote_addr válido (resultado do DNS em cache)
+    struct tcp_pcb *pcb;                      // Conexão keep-alive (NULL quando fechada)
+    volatile http_client_state_t state;
+
+    http_request_t queue[HTTP_CLIENT_QUEUE_SIZE];
+    uint32_t head;                            // Requisição mais antiga (a próxima a ser respondida)
+    volatile uint32_t count;
+
+    // Resposta em leitura (pertence à requisição em queue[head])
+    http_response_state_t response_state;
+    char header[HTTP_CLIENT_HEADER_SIZE];
+    size_t header_len;
+    uint8_t header_end;                       // Bytes de "\r\n\r\n" já reconhecidos
+    char body[HTTP_CLIENT_BODY_SIZE];
+    size_t body_len;
+    size_t remaining;                         // Bytes de corpo ainda esperados
+    int status;
+    bool close_after;                         // Resposta com "Connection: close"
+    bool started;                             // Algum byte da resposta atual já chegou
+
+    struct tcp_pcb *callback_pcb;             // PCB cujo callback do lwIP está em andamento
+    struct tcp_pcb *aborted;                  // PCB abortada dentro do próprio callback (deve retornar ERR_ABRT)
+} http_client_t;
+
+static http_client_t client;
+
+static void http_client_timeout(void *arg);
+static void http_client_connect(http_client_t *c);
+static void http_client_open(http_client_t *c);
+
+static inline http_request_t *http_client_at(http_client_t *c, uint32_t i) {
+    return &c->queue[(c->head + i) % HTTP_CLIENT_QUEUE_SIZE];
+}
+
+static void http_client_reset_response(http_client_t *c) {
+    c->response_state = HTTP_RESPONSE_HEADER;
+    c->header_len = 0;
+    c->header[0] = '\0';
+    c->header_end = 0;
+    c->body_len = 0;
+    c->body[0] = '\0';
+    c->remaining = 0;
+    c->status = 0;
+    c->close_after = false;
+    c->started = false;
+}
+
+// Rearma o prazo a cada progresso; sem requisições pendentes não há prazo
+static void http_client_touch(http_client_t *c) {
+    sys_untimeout(http_client_timeout, c);
+    if (c->count) {
+        sys_timeout(HTTP_CLIENT_TIMEOUT_MS, http_client_timeout, c);
+    }
+}
+
+// Retira a requisição mais antiga da fila e avisa quem pediu
+static void http_client_complete(http_client_t *c, http_client_result_t result) {
+    http_request_t *r = http_client_at(c, 0);
+    http_client_done_fn done = r->done;
+    void *arg = r->arg;
+    int status = result == HTTP_CLIENT_OK ? c->status : 0;
+
+    // O corpo é copiado antes de liberar a posição, pois o callback pode enfileirar outra requisição
+    char body[HTTP_CLIENT_BODY_SIZE];
+    memcpy(body, c->body, c->body_len + 1);
+
+    c->head = (c->head + 1) % HTTP_CLIENT_QUEUE_SIZE;
+    c->count--;
+    http_client_reset_response(c);
+    http_client_touch(c);
+    if (done) {
+        done(result, status, body, arg);
+    }
+}
+
+// Desliga os callbacks e fecha a conexão. Se a PCB for abortada durante um callback
+// dela mesma, fica registrada em "aborted" para que esse callback retorne ERR_ABRT,
+// mesmo quando o fechamento acontece dentro do callback de conclusão de uma requisição.
+// Fora de um callback da PCB (timer, envio, abertura) nada é registrado: o lwIP
+// reaproveita o endereço da PCB liberada na próxima conexão.
+static void http_client_close(http_client_t *c, bool abort) {
+    if (c->pcb) {
+        tcp_arg(c->pcb, NULL);
+        tcp_recv(c->pcb, NULL);
+        tcp_sent(c->pcb, NULL);
+        tcp_err(c->pcb, NULL);
+        if (abort || tcp_close(c->pcb) != ERR_OK) {
+            if (c->pcb == c->callback_pcb) {
+                c->aborted = c->pcb;
+            }
+            tcp_abort(c->pcb);
+        }
+        c->pcb = NULL;
+    }
+    c->state = HTTP_CLIENT_IDLE;
+}
+
+// Valor de retorno de um callback da PCB "tpcb"; encerra o callback em andamento
+static inline err_t http_client_cb_result(http_client_t *c, struct tcp_pcb *tpcb) {
+    c->callback_pcb = NULL;
+    if (c->aborted == tpcb) {
+        c->aborted = NULL;
+        return ERR_ABRT;
+    }
+    return ERR_OK;
+}
+
+// A conexão terminou (fechada pelo servidor, derrubada ou abortada): requisições
+// que já esgotaram as tentativas falham, as demais são reenviadas em nova conexão
+static void http_client_connection_lost(http_client_t *c) {
+    http_client_reset_response(c);
+    for (uint32_t i = 0; i < c->count; i++) {
+        http_client_at(c, i)->written = 0;
+    }
+    while (c->count && http_client_at(c, 0)->attempts >= HTTP_CLIENT_MAX_ATTEMPTS) {
+        http_client_complete(c, HTTP_CLIENT_ERR_ABORTED);
+    }
+    if (c->count && c->state == HTTP_CLIENT_IDLE) {
+        http_client_connect(c);
+    }
+}
+
+// Entrega ao TCP tudo o que couber das requisições ainda não enviadas, sem esperar respostas
+static err_t http_client_send_pending(http_client_t *c) {
+    if (c->state != HTTP_CLIENT_CONNECTED) {
+        return ERR_OK;
+    }
+    bool queued = false;
+    for (uint32_t i = 0; i < c->count; i++) {
+        http_request_t *r = http_client_at(c, i);
+        if (r->written == r->len) {
+            continue;
+        }
+        size_t room = tcp_sndbuf(c->pcb);
+        size_t n = r->len - r->written;
+        if (n > room) {
+            n = room;
+        }
+        if (n == 0) {
+            break;  // Buffer de envio cheio: continua no callback de "sent"
+        }
+        u8_t flags = TCP_WRITE_FLAG_COPY | (i + 1 < c->count || n < r->len - r->written ? TCP_WRITE_FLAG_MORE : 0);
+        err_t err = tcp_write(c->pcb, r->request + r->written, (u16_t)n, flags);
+        if (err == ERR_MEM) {
+            break;  // Sem memória agora: tenta de novo quando algo for confirmado
+        }
+        if (err != ERR_OK) {
+            printf("DEBUG: Erro ao enviar requisicao: %d\n", err);
+            return err;
+        }
+        if (r->written == 0) {
+            r->attempts++;
+        }
+        r->written += n;
+        queued = true;
+        if (r->written < r->len) {
+            break;
+        }
+    }
+    return queued ? tcp_output(c->pcb) : ERR_OK;
+}
+
+// Analisa o cabeçalho completo: status, Content-Length e Connection
+static void http_client_parse_header(http_client_t *c) {
+    if (strncmp(c->header, "HTTP/1.", 7) == 0 && c->header_len >= 12) {
+        c->status = atoi(c->header + 9);
+    }
+    // HTTP/1.0 fecha a conexão por padrão; HTTP/1.1 mantém
+    c->close_after = strncmp(c->header, "HTTP/1.0", 8) == 0;
+
+    bool has_length = false;
+    for (char *line = strstr(c->header, "\r\n"); line; line = strstr(line, "\r\n")) {
+        line += 2;
+        if (strncasecmp(line, "Content-Length:", 15) == 0) {
+            c->remaining = (size_t)atoi(line + 15);
+            has_length = true;
+        } else if (strncasecmp(line, "Connection:", 11) == 0) {
+            const char *value = line + 11;
+            while (*value == ' ') value++;
+            if (strncasecmp(value, "close", 5) == 0) {
+                c->close_after = true;
+            } else if (strncasecmp(value, "keep-alive", 10) == 0) {
+                c->close_after = false;
+            }
+        }
+    }
+    c->response_state = has_length ? HTTP_RESPONSE_BODY : HTTP_RESPONSE_UNTIL_CLOSE;
+}
+
+// Consome bytes recebidos; cada resposta completa é entregue à requisição mais antiga.
+// Retorna false se a conexão precisa ser fechada (resposta com "Connection: close").
+static bool http_client_feed(http_client_t *c, const char *data, size_t len) {
+    static const char header_end[] = "\r\n\r\n";
+
+    while (len) {
+        if (!c->count) {
+            return false;  // Dados sem requisição correspondente: conexão fora de sincronia
+        }
+        c->started = true;
+        if (c->response_state == HTTP_RESPONSE_HEADER) {
+            char ch = *data++;
+            len--;
+            if (c->header_len < sizeof(c->header) - 1) {
+                c->header[c->header_len++] = ch;
+                c->header[c->header_len] = '\0';
+            }
+            c->header_end = ch == header_end[c->header_end] ? c->header_end + 1 : (ch == '\r' ? 1 : 0);
+            if (c->header_end == 4) {
+                http_client_parse_header(c);
+            }
+        } else {
+            size_t n = len;
+            if (c->response_state == HTTP_RESPONSE_BODY && n > c->remaining) {
+                n = c->remaining;
+            }
+            size_t room = sizeof(c->body) - 1 - c->body_len;
+            size_t copy = n < room ? n : room;
+            memcpy(c->body + c->body_len, data, copy);
+            c->body_len += copy;
+            c->body[c->body_len] = '\0';
+            if (c->response_state == HTTP_RESPONSE_BODY) {
+                c->remaining -= n;
+            }
+            data += n;
+            len -= n;
+        }
+
+        if (c->response_state == HTTP_RESPONSE_BODY && c->remaining == 0) {
+            bool close_after = c->close_after;
+            http_client_complete(c, HTTP_CLIENT_OK);
+            if (close_after) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Prazo esgotado: a requisição mais antiga falha e a conexão é refeita para as demais
+static void http_client_timeout(void *arg) {
+    http_client_t *c = (http_client_t *)arg;
+    printf("DEBUG: Tempo esgotado aguardando o servidor HTTP\n");
+    bool connecting = c->state == HTTP_CLIENT_CONNECTING;
+    http_client_close(c, true);
+    if (connecting) {
+        c->resolved = false;  // Refaz o DNS na próxima tentativa
+        while (c->count) {
+            http_client_complete(c, HTTP_CLIENT_ERR_CONNECT);
+        }
+        return;
+    }
+    if (c->count) {
+        http_client_complete(c, HTTP_CLIENT_ERR_TIMEOUT);
+    }
+    http_client_connection_lost(c);
+}
+
+// Erro fatal na conexão: o lwIP já liberou a PCB
+static void http_client_err(void *arg, err_t err) {
+    http_client_t *c = (http_client_t *)arg;
+    printf("DEBUG: Conexao HTTP derrubada: %d\n", err);
+    bool connecting = c->state == HTTP_CLIENT_CONNECTING;
+    c->pcb = NULL;
+    c->state = HTTP_CLIENT_IDLE;
+    if (connecting) {
+        // Servidor inacessível: não adianta insistir com a fila atual. O endereço
+        // em cache é descartado, pois o nome pode ter passado a outro IP.
+        c->resolved = false;
+        while (c->count) {
+            http_client_complete(c, HTTP_CLIENT_ERR_CONNECT);
+        }
+        return;
+    }
+    http_client_connection_lost(c);
+}
+
+static err_t http_client_recv(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t err) {
+    http_client_t *c = (http_client_t *)arg;
+    c->callback_pcb = tpcb;
+    if (!p) {
+        // Servidor fechou: conclui uma resposta sem Content-Length e reconecta se ainda houver fila
+        if (c->count && c->response_state == HTTP_RESPONSE_UNTIL_CLOSE) {
+            http_client_complete(c, HTTP_CLIENT_OK);
+        }
+        if (c->pcb == tpcb) {
+            http_client_close(c, false);
+            http_client_connection_lost(c);
+        }
+        return http_client_cb_result(c, tpcb);
+    }
+
+    bool keep = true;
+    for (struct pbuf *q = p; q && keep && c->pcb == tpcb; q = q->next) {
+        keep = http_client_feed(c, (const char *)q->payload, q->len);
+    }
+    if (c->pcb == tpcb) {
+        tcp_recved(tpcb, p->tot_len);  // Informa ao TCP que os dados foram processados
+        if (!keep) {
+            http_client_close(c, false);
+            http_client_connection_lost(c);
+        }
+    }
+    pbuf_free(p);
+    http_client_touch(c);
+    return http_client_cb_result(c, tpcb);
+}
+
+static err_t http_client_sent(void *arg, struct tcp_pcb *tpcb, u16_t len) {
+    http_client_t *c = (http_client_t *)arg;
+    c->callback_pcb = tpcb;
+    http_client_touch(c);
+    if (http_client_send_pending(c) != ERR_OK) {
+        http_client_close(c, true);
+        http_client_connection_lost(c);
+    }
+    return http_client_cb_result(c, tpcb);
+}
+
+static err_t http_client_connected(void *arg, struct tcp_pcb *tpcb, err_t err) {
+    http_client_t *c = (http_client_t *)arg;
+    c->callback_pcb = tpcb;
+    c->state = HTTP_CLIENT_CONNECTED;
+    http_client_touch(c);
+    if (err != ERR_OK || http_client_send_pending(c) != ERR_OK) {
+        http_client_close(c, true);
+        http_client_connection_lost(c);
+    }
+    return http_client_cb_result(c, tpcb);
+}
+
+// Resposta do DNS (contexto do lwIP): guarda o endereço e abre a conexão
+static void http_client_dns_found(const char *name, const ip_addr_t *ipaddr, void *arg) {
+    http_client_t *c = (http_client_t *)arg;
+    if (c->state != HTTP_CLIENT_CONNECTING || c->pcb) {
+        return;  // Resposta atrasada de uma tentativa já encerrada
+    }
+    c->state = HTTP_CLIENT_IDLE;
+    if (!ipaddr) {
+        printf("DEBUG: Erro ao resolver %s\n", name);
+        while (c->count) {
+            http_client_complete(c, HTTP_CLIENT_ERR_CONNECT);
+        }
+        return;
+    }
+    c->remote_addr = *ipaddr;
+    c->resolved = true;
+    if (c->count) {
+        http_client_open(c);
+    }
+}
+
+// Resolve o servidor (uma vez; o resultado fica em cache) e abre a conexão
+static void http_client_connect(http_client_t *c) {
+    if (!c->resolved) {
+        err_t err = dns_gethostbyname(c->host, &c->remote_addr, http_client_dns_found, c);
+        if (err == ERR_INPROGRESS) {
+            c->state = HTTP_CLIENT_CONNECTING;  // Aguardando o DNS, ainda sem PCB
+            http_client_touch(c);
+            return;
+        }
+        if (err != ERR_OK) {
+            printf("DEBUG: Erro ao resolver %s: %d\n", c->host, err);
+            while (c->count) {
+                http_client_complete(c, HTTP_CLIENT_ERR_CONNECT);
+            }
+            return;
+        }
+        c->resolved = true;  // Endereço IP literal ou nome já no cache do lwIP
+    }
+    http_client_open(c);
+}
+
+// Abre a conexão keep-alive; as requisições da fila seguem assim que ela for aceita
+static void http_client_open(http_client_t *c) {
+    c->pcb = tcp_new_ip_type(IP_GET_TYPE(&c->remote_addr));
+    if (!c->pcb) {
+        printf("DEBUG: Erro ao criar PCB TCP\n");
+        while (c->count) {
+            http_client_complete(c, HTTP_CLIENT_ERR_CONNECT);
+        }
+        return;
+    }
+    tcp_arg(c->pcb, c);
+    tcp_recv(c->pcb, http_client_recv);
+    tcp_sent(c->pcb, http_client_sent);
+    tcp_err(c->pcb, http_client_err);
+    tcp_nagle_disable(c->pcb);  // Requisições pequenas saem sem esperar ACK
+
+    c->state = HTTP_CLIENT_CONNECTING;
+    err_t err = tcp_connect(c->pcb, &c->remote_addr, c->port, http_client_connected);
+    if (err != ERR_OK) {
+        printf("DEBUG: Erro ao conectar ao servidor: %d\n", err);
+        http_client_close(c, true);
+        while (c->count) {
+            http_client_complete(c, HTTP_CLIENT_ERR_CONNECT);
+        }
+        return;
+    }
+    http_client_touch(c);
+}
+
+void http_client_init(const char *host, uint16_t port) {
+    cyw43_arch_lwip_begin();
+    if (client.pcb) {
+        http_client_close(&client, false);  // Outro servidor: a conexão antiga não serve mais
+    }
+    snprintf(client.host, sizeof(client.host), "%s", host);
+    client.port = port;
+    client.resolved = false;  // Resolvido no primeiro envio, quando a rede já estiver ativa
+    cyw43_arch_lwip_end();
+}
+
+bool http_client_post(const char *path, const char *content_type, const char *body,
+                      http_client_done_fn done, void *arg) {
+    http_client_t *c = &client;
+    bool ok = false;
+
+    cyw43_arch_lwip_begin();
+    if (c->count < HTTP_CLIENT_QUEUE_SIZE) {
+        http_request_t *r = http_client_at(c, c->count);
+        // Sem "Connection: close": em HTTP/1.1 a conexão fica aberta para as próximas requisições
+        int len = snprintf(r->request, sizeof(r->request),
+                           "POST %s HTTP/1.1\r\n"
+                           "Host: %s\r\n"
+                           "Content-Type: %s\r\n"
+                           "Content-Length: %d\r\n"
+                           "\r\n"
+                           "%s",
+                           path, c->host, content_type, (int)strlen(body), body);
+        if (len > 0 && (size_t)len < sizeof(r->request)) {
+            r->len = (size_t)len;
+            r->written = 0;
+            r->attempts = 0;
+            r->done = done;
+            r->arg = arg;
+            if (c->count++ == 0) {
+                http_client_reset_response(c);
+            }
+            ok = true;
+
+            if (c->state == HTTP_CLIENT_IDLE) {
+                http_client_connect(c);
+            } else if (http_client_send_pending(c) != ERR_OK) {
+                http_client_close(c, true);
+                http_client_connection_lost(c);
+            } else {
+                http_client_touch(c);
+            }
+        } else {
+            printf("DEBUG: Requisicao HTTP maior que o buffer\n");
+        }
+    }
+    cyw43_arch_lwip_end();
+    return ok;
+}
+
+bool http_client_post_json(const char *path, const char *json, http_client_done_fn done, void *arg) {
+    return http_client_post(path, "application/json", json, done, arg);
+}
+
+uint32_t http_client_pending(void) {
+    return client.count;
+}
+
+http_client_state_t http_client_state(void) {
+    return client.state;
+}
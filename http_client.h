@@ -0,0 +1,65 @@
+#ifndef HTTP_CLIENT_H
+#define HTTP_CLIENT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Tempo máximo sem progresso enquanto houver requisições aguardando resposta
+#define HTTP_CLIENT_TIMEOUT_MS 5000
+
+// Requisições enfileiradas/em andamento ao mesmo tempo (pipelining)
+#define HTTP_CLIENT_QUEUE_SIZE 4
+
+// Envios de uma mesma requisição antes de desistir (reconexões transparentes)
+#define HTTP_CLIENT_MAX_ATTEMPTS 2
+
+// Tamanhos dos buffers estáticos
+#define HTTP_CLIENT_REQUEST_SIZE 1664   // Requisição completa (cabeçalho + corpo, comporta um lote de resultados)
+#define HTTP_CLIENT_HEADER_SIZE 256     // Cabeçalho da resposta guardado para análise
+#define HTTP_CLIENT_BODY_SIZE 256       // Início do corpo da resposta entregue ao callback
+
+// Resultado de uma requisição
+typedef enum {
+    HTTP_CLIENT_OK = 0,            // Resposta recebida (ver status HTTP)
+    HTTP_CLIENT_ERR_CONNECT,       // Falha ao criar a conexão ou conexão recusada
+    HTTP_CLIENT_ERR_SEND,          // Falha ao enfileirar a requisição no TCP
+    HTTP_CLIENT_ERR_TIMEOUT,       // Servidor não respondeu a tempo
+    HTTP_CLIENT_ERR_ABORTED        // Conexão caiu em todas as tentativas
+} http_client_result_t;
+
+// Estado da conexão persistente com o servidor
+typedef enum {
+    HTTP_CLIENT_IDLE = 0,          // Sem conexão aberta
+    HTTP_CLIENT_CONNECTING,
+    HTTP_CLIENT_CONNECTED          // Conexão keep-alive aberta
+} http_client_state_t;
+
+// Chamado no contexto do lwIP ao final de cada requisição. "status" é o código
+// HTTP (0 se não houve resposta) e "body" aponta para o início do corpo da
+// resposta, válido apenas durante o callback.
+typedef void (*http_client_done_fn)(http_client_result_t result, int status, const char *body, void *arg);
+
+// Define o servidor (nome ou endereço IP em texto, e porta) das requisições
+// seguintes. O nome é resolvido por DNS na primeira conexão e mantido em cache.
+void http_client_init(const char *host, uint16_t port);
+
+// Enfileira um POST com corpo JSON e retorna imediatamente. As requisições
+// seguem em ordem pela mesma conexão keep-alive, sem esperar a resposta da
+// anterior; se o servidor fechar a conexão, ela é reaberta e as requisições
+// ainda sem resposta são reenviadas. Retorna false se a fila estiver cheia ou
+// a requisição não couber no buffer.
+// Pode ser chamada fora do contexto do lwIP (usa cyw43_arch_lwip_begin/end).
+bool http_client_post_json(const char *path, const char *json, http_client_done_fn done, void *arg);
+
+// Igual a http_client_post_json(), com o Content-Type informado (ex.: "application/x-ndjson")
+bool http_client_post(const char *path, const char *content_type, const char *body,
+                      http_client_done_fn done, void *arg);
+
+// Requisições ainda sem resposta
+uint32_t http_client_pending(void);
+
+// Estado da conexão persistente
+http_client_state_t http_client_state(void);
+
+#endif // HTTP_CLIENT_H
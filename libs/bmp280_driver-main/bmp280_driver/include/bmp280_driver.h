@@ -4,6 +4,8 @@
 #include <stdint.h>
 #include <hardware/i2c.h>
 
+#include "i2c_bus.h"
+
 #define BMP280_DEFAULT_I2C_PORT i2c0
 
 /*
@@ -11,15 +13,22 @@
 */
 
 #define BMP280_I2C_ADDRESS 0x77
+#define BMP280_I2C_ADDRESS_ALT 0x76
 #define BMP280_CHIP_ID_REG 0xD0
 #define BMP280_CHIP_ID 0x58
+#define BMP280_STATUS_REG 0xF3
+#define BMP280_STATUS_MEASURING 0x08
+#define BMP280_STATUS_IM_UPDATE 0x01
 #define BMP280_POWER_CTL_REG 0xF4
+#define BMP280_CONFIG_REG 0xF5
 #define BMP280_RESET_REG 0xE0
 #define BMP280_RESET_VAL 0xB6
 #define BMP280_PRESSURE_REG_LOW 0xF7
 #define BMP280_PRESSURE_REG_HIGH 0xF9
 #define BMP280_TEMPERATURE_REG_LOW 0xFA
 #define BMP280_TEMPERATURE_REG_HIGH 0xFC
+#define BMP280_DATA_REG 0xF7
+#define BMP280_DATA_SIZE 6
 
 #define BMP280_CAL_T1_REG 0x88
 #define BMP280_CAL_T2_REG 0x8A
@@ -45,26 +54,164 @@
 #define BMP280_MODE_FORCE   0x01
 #define BMP280_MODE_NORMAL  0x03
 
+#define BMP280_FILTER_OFF   0x00
+#define BMP280_FILTER_X2    0x01
+#define BMP280_FILTER_X4    0x02
+#define BMP280_FILTER_X8    0x03
+#define BMP280_FILTER_X16   0x04
+
+#define BMP280_STANDBY_0_5_MS   0x00
+#define BMP280_STANDBY_62_5_MS  0x01
+#define BMP280_STANDBY_125_MS   0x02
+#define BMP280_STANDBY_250_MS   0x03
+#define BMP280_STANDBY_500_MS   0x04
+#define BMP280_STANDBY_1000_MS  0x05
+#define BMP280_STANDBY_2000_MS  0x06
+#define BMP280_STANDBY_4000_MS  0x07
+
+#define BMP280_STARTUP_TIMEOUT_MS   20      // chip ID polling after power-on
+#define BMP280_STATUS_POLL_US       500     // status re-check while a conversion is still running
+#define BMP280_STATUS_POLL_MAX      8
+
+#define BMP280_WRITE_MAX_REGS       8       // registers per write transaction, buffer on the stack
+#define BMP280_SEA_LEVEL_PA         101325  // standard atmosphere
+#define BMP280_TREND_SHIFT          3       // pressure trend smoothing, alpha = 1/8
+
+
+
+/*
+    Calibration words, decoded once from coefficients[] by bmp280_i2c_calibrate()
+*/
+
+typedef struct bmp280_calib {
+
+    uint16_t dig_T1;
+    int16_t  dig_T2;
+    int16_t  dig_T3;
+
+    uint16_t dig_P1;
+    int16_t  dig_P2;
+    int16_t  dig_P3;
+    int16_t  dig_P4;
+    int16_t  dig_P5;
+    int16_t  dig_P6;
+    int16_t  dig_P7;
+    int16_t  dig_P8;
+    int16_t  dig_P9;
+
+} bmp280_calib;
+
+
+
+/*
+    ctrl_meas (0xF4) and config (0xF5) settings
+*/
+
+typedef struct bmp280_config {
+    uint8_t osrs_t;     // BMP280_OVERSCAN_* of temperature
+    uint8_t osrs_p;     // BMP280_OVERSCAN_* of pressure
+    uint8_t mode;       // BMP280_MODE_*
+    uint8_t filter;     // BMP280_FILTER_*
+    uint8_t standby;    // BMP280_STANDBY_*, normal mode only
+} bmp280_config;
+
+// datasheet section 3.8 use cases
+typedef enum bmp280_profile {
+    BMP280_PROFILE_LOW_LATENCY = 0,     // pressure x2, temperature x1, no filter, normal mode without standby
+    BMP280_PROFILE_LOW_POWER,           // pressure x1, temperature x1, no filter, forced mode on demand
+    BMP280_PROFILE_HIGH_RESOLUTION      // pressure x16, temperature x2, IIR x16, normal mode without standby
+} bmp280_profile;
 
+typedef struct bmp280_timing {
+    uint32_t measurement_us;    // maximum measurement time
+    uint32_t period_us;         // measurement + standby in normal mode, measurement alone in forced mode
+    uint32_t rate_mhz;          // maximum output data rate in mHz
+} bmp280_timing;
 
-typedef struct bmp280 {
+
+
+typedef struct bmp280_trend {
+    int64_t  pressure;          // smoothed pressure, Pa in Q48.16
+    uint64_t timestamp_us;
+    int32_t  pa_per_hour;       // smoothed rate of change, Pa/h with BMP280_TREND_SHIFT fraction bits
+    bool     valid;
+} bmp280_trend;
+
+
+
+typedef struct bmp280 bmp280;
+
+// called when an asynchronous sample finished, result < 0 on bus error or timeout
+typedef void (*bmp280_sample_cb)(bmp280* device, int result);
+
+typedef enum bmp280_sampler_state {
+    BMP280_SAMPLER_IDLE = 0,
+    BMP280_SAMPLER_TRIGGER,     // writing ctrl_meas with forced mode
+    BMP280_SAMPLER_WAIT,        // conversion running, alarm pending
+    BMP280_SAMPLER_STATUS,      // reading the status register
+    BMP280_SAMPLER_DATA         // burst reading 0xF7-0xFC
+} bmp280_sampler_state;
+
+typedef struct bmp280_sampler {
+    volatile bmp280_sampler_state state;
+    bmp280_sample_cb done;
+    i2c_xfer_t xfer;
+    uint8_t tx[2];
+    uint8_t rx[BMP280_DATA_SIZE];
+    uint8_t polls;
+} bmp280_sampler;
+
+
+
+struct bmp280 {
+
+    i2c_dev_t dev;
+
+    bmp280_config config;
 
     uint8_t coefficients[24];
+    bmp280_calib calib;
 
     double pressure;
     double temperature;
 
-} bmp280;
+    int32_t  t_fine;            // shared by temperature and pressure compensation
+    int32_t  temperature_int;   // 0.01 degC, 2508 = 25.08 degC
+    uint32_t pressure_int;      // Pa in Q24.8, divide by 256 for Pa
+
+    uint32_t sea_level;         // altitude reference, Pa in Q24.8
+
+    bmp280_sampler sampler;
 
+};
 
 
-extern void bmp280_i2c_read_reg(const uint8_t reg, const uint32_t size, uint8_t* dst);
 
-extern void bmp280_i2c_write_reg(const uint8_t reg, const uint32_t size, uint8_t* src);
+extern void bmp280_i2c_init(bmp280* device, i2c_bus_t* bus, const uint8_t address);
+
+/*
+    Register I/O, no heap: reads go straight into dst, writes are built on the
+    stack. On an asynchronous i2c_bus these block until the bus finished the
+    transfer, so in interrupt context use bmp280_sample_async instead.
+*/
+
+extern int bmp280_i2c_read_reg(bmp280* device, const uint8_t reg, const uint32_t size, uint8_t* dst);
+
+extern int bmp280_i2c_write_reg(bmp280* device, const uint8_t reg, const uint32_t size, const uint8_t* src);
 
+extern int bmp280_i2c_write_regs(bmp280* device, const uint8_t* regs, const uint8_t* values, const uint32_t count);
 
 
-extern int bmp280_i2c_setup();
+
+extern int bmp280_i2c_setup(bmp280* device);
+
+extern int bmp280_i2c_configure(bmp280* device, const bmp280_config* config);
+
+extern int bmp280_i2c_set_profile(bmp280* device, const bmp280_profile profile);
+
+extern void bmp280_profile_config(const bmp280_profile profile, bmp280_config* config);
+
+extern void bmp280_get_timing(const bmp280* device, bmp280_timing* timing);
 
 extern void bmp280_i2c_calibrate(bmp280* device);
 
@@ -72,6 +219,71 @@ extern void bmp280_i2c_read_pressure(bmp280* device);
 
 extern void bmp280_i2c_read_temperature(bmp280* device);
 
+extern void bmp280_i2c_read_pressure_int(bmp280* device);
+
+extern void bmp280_i2c_read_temperature_int(bmp280* device);
+
+extern int bmp280_i2c_read_all(bmp280* device);
+
+extern void bmp280_compensate_burst(bmp280* device, const uint8_t* data);
+
+
+
+/*
+    Asynchronous forced mode sampling
+
+    bmp280_sample_async() writes ctrl_meas with the device oversampling and
+    forced mode, waits the datasheet maximum measurement time on an alarm,
+    checks the measuring bit of the status register and then burst reads
+    the result. Every step runs from bus and alarm callbacks; done is called
+    in interrupt context with the compensated values stored in the device.
+*/
+
+extern uint32_t bmp280_measurement_time_us(const bmp280* device);
+
+extern bool bmp280_sample_async(bmp280* device, bmp280_sample_cb done);
+
+extern bool bmp280_sample_busy(const bmp280* device);
+
+
+
+/*
+    Compensation of raw 20 bit readings, datasheet section 8.2
+*/
+
+extern int32_t bmp280_compensate_temperature(const bmp280_calib* calib, const int32_t adc_t, int32_t* t_fine);
+
+extern uint32_t bmp280_compensate_pressure(const bmp280_calib* calib, const int32_t adc_p, const int32_t t_fine);
+
+extern double bmp280_compensate_temperature_double(const bmp280_calib* calib, const int32_t adc_t);
+
+extern double bmp280_compensate_pressure_double(const bmp280_calib* calib, const int32_t adc_p, const double temperature);
+
+
+
+/*
+    Barometric altitude
+
+    h = 44330 * (1 - (p / p0) ^ (1 / 5.255)), evaluated from a 129 entry table
+    over p / p0 = 0.25 .. 1.25 (about -1920 m .. 10280 m) with linear
+    interpolation, no floating point. Against the pow() version the measured
+    error is at most 6.3 cm for 90..110 kPa and 62.4 cm over the whole table,
+    the worst near its top end (25.5..27.5 kPa, about 10 km); altitudes outside
+    the table are clamped. The benchmark example measures both.
+*/
+
+extern int32_t bmp280_altitude_cm(const uint32_t pressure, const uint32_t sea_level);
+
+extern uint32_t bmp280_sea_level_pressure(const uint32_t pressure, const int32_t altitude_cm);
+
+extern double bmp280_altitude_double(const double pressure, const double sea_level);
+
+extern int32_t bmp280_altitude(const bmp280* device);
+
+extern void bmp280_altitude_calibrate(bmp280* device, const int32_t altitude_cm);
+
+extern int32_t bmp280_trend_update(bmp280_trend* trend, const uint32_t pressure, const uint64_t timestamp_us);
+
 
 
 #endif // I2C_H
@@ -1,106 +1,514 @@
 #include "bmp280_driver.h"
 
-#include <stdlib.h>
+#include <math.h>
 #include <pico/stdlib.h>
 
-void bmp280_i2c_write_reg(const uint8_t reg, const uint32_t size, uint8_t* src) {
-    uint8_t* buff = (uint8_t*)calloc(size + 1, 1);
-    buff[0] = reg;
+void bmp280_i2c_init(bmp280* device, i2c_bus_t* bus, const uint8_t address) {
+    device->dev.bus = bus;
+    device->dev.address = address;
+    device->config = (bmp280_config){
+        .osrs_t = BMP280_OVERSCAN_X2,
+        .osrs_p = BMP280_OVERSCAN_X16,
+        .mode = BMP280_MODE_NORMAL,
+        .filter = BMP280_FILTER_OFF,
+        .standby = BMP280_STANDBY_0_5_MS,
+    };
+    device->sampler.state = BMP280_SAMPLER_IDLE;
+    device->sea_level = (uint32_t)BMP280_SEA_LEVEL_PA << 8;
+}
+
+int bmp280_i2c_write_regs(bmp280* device, const uint8_t* regs, const uint8_t* values, const uint32_t count) {
+    // writes have no auto-increment: every data byte is preceded by its register address
+    uint8_t buff[2 * BMP280_WRITE_MAX_REGS];
+    if (count == 0 || count > BMP280_WRITE_MAX_REGS) {
+        return PICO_ERROR_INVALID_ARG;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        buff[2*i] = regs[i];
+        buff[2*i+1] = values[i];
+    }
+    return i2c_dev_write_blocking(&device->dev, buff, 2 * count);
+}
+
+int bmp280_i2c_write_reg(bmp280* device, const uint8_t reg, const uint32_t size, const uint8_t* src) {
+    uint8_t regs[BMP280_WRITE_MAX_REGS];
+    if (size == 0 || size > BMP280_WRITE_MAX_REGS) {
+        return PICO_ERROR_INVALID_ARG;
+    }
     for (uint32_t i = 0; i < size; i++) {
-        buff[i+1] = src[i];
+        regs[i] = reg + i;
     }
-    i2c_write_blocking(BMP280_DEFAULT_I2C_PORT, BMP280_I2C_ADDRESS, buff, size+1, 0);
-    free(buff);
+    return bmp280_i2c_write_regs(device, regs, src, size);
 }
 
-void bmp280_i2c_read_reg(const uint8_t reg, const uint32_t size, uint8_t* dst) {
-    uint8_t _reg = reg;
-    i2c_write_blocking(BMP280_DEFAULT_I2C_PORT, BMP280_I2C_ADDRESS, &reg, 1, 1);
-    i2c_read_blocking(BMP280_DEFAULT_I2C_PORT, BMP280_I2C_ADDRESS, dst, size, 0);
+int bmp280_i2c_read_reg(bmp280* device, const uint8_t reg, const uint32_t size, uint8_t* dst) {
+    return i2c_dev_write_read_blocking(&device->dev, &reg, 1, dst, size);
 }
 
 /*
     BMP280
 */
 
-int bmp280_i2c_setup() {
+static int bmp280_wait_im_update(bmp280* device) {
+    // the NVM copy after reset takes a few hundred microseconds
+    for (uint32_t i = 0; i < BMP280_STARTUP_TIMEOUT_MS; i++) {
+        uint8_t status;
+        if (bmp280_i2c_read_reg(device, BMP280_STATUS_REG, 1, &status) >= 0 && !(status & BMP280_STATUS_IM_UPDATE)) {
+            return 1;
+        }
+        sleep_ms(1);
+    }
+    return -1;
+}
 
-    sleep_ms(20);
+int bmp280_i2c_setup(bmp280* device) {
 
-    uint8_t chip_ID;
-    bmp280_i2c_read_reg(BMP280_CHIP_ID_REG, 1, &chip_ID);   
+    // poll the chip ID for up to the power-on time instead of waiting it out
+    uint8_t chip_ID = 0;
+    for (uint32_t i = 0; i < BMP280_STARTUP_TIMEOUT_MS; i++) {
+        if (bmp280_i2c_read_reg(device, BMP280_CHIP_ID_REG, 1, &chip_ID) >= 0) {
+            break;
+        }
+        sleep_ms(1);
+    }
     if (chip_ID != BMP280_CHIP_ID) {
         return -1;
     }
 
     //reset registers
     uint8_t reset_val = BMP280_RESET_VAL;
-    bmp280_i2c_write_reg(BMP280_RESET_REG, 1, &reset_val);
-    sleep_ms(10);
+    bmp280_i2c_write_reg(device, BMP280_RESET_REG, 1, &reset_val);
+    if (bmp280_wait_im_update(device) < 0) {
+        return -1;
+    }
+
+    // power ctl and config
+    if (bmp280_i2c_configure(device, &device->config) < 0) {
+        return -1;
+    }
 
-    // power ctl
-    uint8_t ctl_data = (((BMP280_OVERSCAN_X2 << 3) | BMP280_OVERSCAN_X16) << 2) | BMP280_MODE_NORMAL;
-    bmp280_i2c_write_reg(BMP280_POWER_CTL_REG, 1, &ctl_data);
-    sleep_ms(10);
+    // the first normal mode result is ready after one measurement
+    if (device->config.mode == BMP280_MODE_NORMAL) {
+        sleep_us(bmp280_measurement_time_us(device));
+    }
     return 1;
 
 }
 
+static inline uint8_t bmp280_ctrl_meas(const bmp280_config* config, const uint8_t mode) {
+    return (uint8_t)((config->osrs_t << 5) | (config->osrs_p << 2) | mode);
+}
+
+int bmp280_i2c_configure(bmp280* device, const bmp280_config* config) {
+    // config is only reliably written in sleep mode: sleep, config, then ctrl_meas, in one write
+    const uint8_t regs[3] = { BMP280_POWER_CTL_REG, BMP280_CONFIG_REG, BMP280_POWER_CTL_REG };
+    const uint8_t values[3] = {
+        bmp280_ctrl_meas(config, BMP280_MODE_SLEEP),
+        (uint8_t)((config->standby << 5) | (config->filter << 2)),
+        bmp280_ctrl_meas(config, config->mode == BMP280_MODE_NORMAL ? BMP280_MODE_NORMAL : BMP280_MODE_SLEEP)
+    };
+    int ret = bmp280_i2c_write_regs(device, regs, values, 3);
+    if (ret < 0) {
+        return ret;
+    }
+    device->config = *config;
+    return ret;
+}
+
+void bmp280_profile_config(const bmp280_profile profile, bmp280_config* config) {
+    switch (profile) {
+    case BMP280_PROFILE_LOW_POWER:
+        *config = (bmp280_config){ BMP280_OVERSCAN_X1, BMP280_OVERSCAN_X1, BMP280_MODE_FORCE, BMP280_FILTER_OFF, BMP280_STANDBY_0_5_MS };
+        break;
+    case BMP280_PROFILE_HIGH_RESOLUTION:
+        *config = (bmp280_config){ BMP280_OVERSCAN_X2, BMP280_OVERSCAN_X16, BMP280_MODE_NORMAL, BMP280_FILTER_X16, BMP280_STANDBY_0_5_MS };
+        break;
+    case BMP280_PROFILE_LOW_LATENCY:
+    default:
+        *config = (bmp280_config){ BMP280_OVERSCAN_X1, BMP280_OVERSCAN_X2, BMP280_MODE_NORMAL, BMP280_FILTER_OFF, BMP280_STANDBY_0_5_MS };
+        break;
+    }
+}
+
+int bmp280_i2c_set_profile(bmp280* device, const bmp280_profile profile) {
+    bmp280_config config;
+    bmp280_profile_config(profile, &config);
+    return bmp280_i2c_configure(device, &config);
+}
+
+static inline uint16_t bmp280_u16(const uint8_t* src) {
+    return (uint16_t)((src[1] << 8) | src[0]);
+}
+
+static inline int32_t bmp280_adc20(const uint8_t* src) {
+    return ((int32_t)src[0] << 12) | ((int32_t)src[1] << 4) | (src[2] >> 4);
+}
+
 void bmp280_i2c_calibrate(bmp280* device) {
-    bmp280_i2c_read_reg(BMP280_CAL_T1_REG, 24, device->coefficients);
+    bmp280_i2c_read_reg(device, BMP280_CAL_T1_REG, 24, device->coefficients);
+
+    const uint8_t* c = device->coefficients;
+    bmp280_calib* calib = &device->calib;
+    calib->dig_T1 = bmp280_u16(&c[0]);
+    calib->dig_T2 = (int16_t)bmp280_u16(&c[2]);
+    calib->dig_T3 = (int16_t)bmp280_u16(&c[4]);
+    calib->dig_P1 = bmp280_u16(&c[6]);
+    calib->dig_P2 = (int16_t)bmp280_u16(&c[8]);
+    calib->dig_P3 = (int16_t)bmp280_u16(&c[10]);
+    calib->dig_P4 = (int16_t)bmp280_u16(&c[12]);
+    calib->dig_P5 = (int16_t)bmp280_u16(&c[14]);
+    calib->dig_P6 = (int16_t)bmp280_u16(&c[16]);
+    calib->dig_P7 = (int16_t)bmp280_u16(&c[18]);
+    calib->dig_P8 = (int16_t)bmp280_u16(&c[20]);
+    calib->dig_P9 = (int16_t)bmp280_u16(&c[22]);
+}
+
+/*
+    Integer compensation
+*/
+
+int32_t bmp280_compensate_temperature(const bmp280_calib* calib, const int32_t adc_t, int32_t* t_fine) {
+    int32_t var1 = ((((adc_t >> 3) - ((int32_t)calib->dig_T1 << 1))) * ((int32_t)calib->dig_T2)) >> 11;
+    int32_t var2 = (((((adc_t >> 4) - ((int32_t)calib->dig_T1)) * ((adc_t >> 4) - ((int32_t)calib->dig_T1))) >> 12) *
+                   ((int32_t)calib->dig_T3)) >> 14;
+
+    *t_fine = var1 + var2;
+    return (*t_fine * 5 + 128) >> 8;
+}
+
+uint32_t bmp280_compensate_pressure(const bmp280_calib* calib, const int32_t adc_p, const int32_t t_fine) {
+    // left shifts of signed terms are written as multiplications, the datasheet shifts negative values
+    int64_t var1 = ((int64_t)t_fine) - 128000;
+    int64_t var2 = var1 * var1 * (int64_t)calib->dig_P6;
+    var2 = var2 + ((var1 * (int64_t)calib->dig_P5) * ((int64_t)1 << 17));
+    var2 = var2 + (((int64_t)calib->dig_P4) * ((int64_t)1 << 35));
+    var1 = ((var1 * var1 * (int64_t)calib->dig_P3) >> 8) + ((var1 * (int64_t)calib->dig_P2) * ((int64_t)1 << 12));
+    var1 = (((((int64_t)1) << 47) + var1)) * ((int64_t)calib->dig_P1) >> 33;
+    if (var1 == 0) {
+        return 0; // avoid division by zero
+    }
+
+    int64_t p = 1048576 - adc_p;
+    p = (((p << 31) - var2) * 3125) / var1;
+    var1 = (((int64_t)calib->dig_P9) * (p >> 13) * (p >> 13)) >> 25;
+    var2 = (((int64_t)calib->dig_P8) * p) >> 19;
+    p = ((p + var1 + var2) >> 8) + (((int64_t)calib->dig_P7) * 16);
+    return (uint32_t)p;
+}
+
+/*
+    Floating point compensation
+*/
+
+double bmp280_compensate_temperature_double(const bmp280_calib* calib, const int32_t adc_t) {
+    double var1 = (adc_t / 16384.0 - calib->dig_T1 / 1024.0) * calib->dig_T2;
+    double var2 = (adc_t / 131072.0 - calib->dig_T1 / 8192.0) *
+                  (adc_t / 131072.0 - calib->dig_T1 / 8192.0) * calib->dig_T3;
+
+    return (var1 + var2) / 5120.0;
+}
+
+double bmp280_compensate_pressure_double(const bmp280_calib* calib, const int32_t adc_p, const double temperature) {
+    double var1 = (temperature * 5120.0 / 2.0) - 64000.0;
+    double var2 = var1 * var1 * calib->dig_P6 / 32768.0;
+    var2 = var2 + var1 * calib->dig_P5 * 2.0;
+    var2 = (var2 / 4.0) + calib->dig_P4 * 65536.0;
+    var1 = (calib->dig_P3 * var1 * var1 / 524288.0 + calib->dig_P2 * var1) / 524288.0;
+    var1 = (1.0 + var1 / 32768.0) * calib->dig_P1;
+    if (var1 == 0.0) {
+        return 0.0; // avoid division by zero
+    }
+
+    double p = 1048576.0 - adc_p;
+    p = (p - (var2 / 4096.0)) * 6250.0 / var1;
+    var1 = calib->dig_P9 * p * p / 2147483648.0;
+    var2 = p * calib->dig_P8 / 32768.0;
+    return p + (var1 + var2 + calib->dig_P7) / 16.0;
 }
 
 void bmp280_i2c_read_pressure(bmp280* device) {
     uint8_t data[3];
-    bmp280_i2c_read_reg(BMP280_PRESSURE_REG_LOW, 3, data);
-
-    double var1 = 0.0;
-    double var2 = 0.0;
-    double var3 = 0.0;
-    int adc_p = 0;
-
-    adc_p = data[0];
-    adc_p <<= 8;
-    adc_p |= data[1];
-    adc_p <<= 4;
-    adc_p |= (data[2] >> 4);
-
-    var1 = (device->temperature * 5120.0 / 2.0) - 64000.0;
-    var2 = var1 * var1 * ((int16_t)((device->coefficients[17] << 8) | device->coefficients[16])) / 32768.0;
-    var2 = var2 + var1 * ((int16_t)((device->coefficients[15] << 8) | device->coefficients[14])) * 2.0;
-    var2 = ( var2 / 4.0 ) + ((int16_t)((device->coefficients[13] << 8) | device->coefficients[12])) * 65536.0;
-    var3 = ((int16_t)((device->coefficients[11] << 8) | device->coefficients[10])) * var1 * var1 / 524288.0;
-    var1 = ( var3 + ((int16_t)((device->coefficients[9] << 8) | device->coefficients[8])) * var1) / 524288.0;
-    var1 = ( 1.0 + var1 / 32768.0) * ((int32_t)((device->coefficients[7] << 8) | device->coefficients[6]));
-    device->pressure = 1048576.0 - adc_p;
-    device->pressure = ( device->pressure - ( var2 / 4096.0)) * 6250.0 / var1;
-    var1 = ((int16_t)((device->coefficients[23] << 8) | device->coefficients[22])) * device->pressure * device->pressure / 2147483648.0;
-    var2 = device->pressure * ((int16_t)((device->coefficients[21] << 8) | device->coefficients[20])) / 32768.0;
-    device->pressure = device->pressure + ( var1 + var2 + ((int16_t)((device->coefficients[19] << 8) | device->coefficients[18]))) / 16.0;
+    bmp280_i2c_read_reg(device, BMP280_PRESSURE_REG_LOW, 3, data);
+
+    device->pressure = bmp280_compensate_pressure_double(&device->calib, bmp280_adc20(data), device->temperature);
 }
 
 void bmp280_i2c_read_temperature(bmp280* device) {
+    uint8_t data[3];
+    bmp280_i2c_read_reg(device, BMP280_TEMPERATURE_REG_LOW, 3, data);
+
+    device->temperature = bmp280_compensate_temperature_double(&device->calib, bmp280_adc20(data));
+}
+
+void bmp280_i2c_read_pressure_int(bmp280* device) {
+    uint8_t data[3];
+    bmp280_i2c_read_reg(device, BMP280_PRESSURE_REG_LOW, 3, data);
 
+    device->pressure_int = bmp280_compensate_pressure(&device->calib, bmp280_adc20(data), device->t_fine);
+}
+
+void bmp280_i2c_read_temperature_int(bmp280* device) {
     uint8_t data[3];
-    bmp280_i2c_read_reg(BMP280_TEMPERATURE_REG_LOW, 3, data);
-    
-    double var1 = 0.0;
-    double var2 = 0.0;
-    int adc_t = 0.0;
+    bmp280_i2c_read_reg(device, BMP280_TEMPERATURE_REG_LOW, 3, data);
+
+    device->temperature_int = bmp280_compensate_temperature(&device->calib, bmp280_adc20(data), &device->t_fine);
+}
+
+void bmp280_compensate_burst(bmp280* device, const uint8_t* data) {
+    // data holds press_msb..temp_xlsb (0xF7-0xFC), both from the same conversion
+    device->temperature_int = bmp280_compensate_temperature(&device->calib, bmp280_adc20(&data[3]), &device->t_fine);
+    device->pressure_int = bmp280_compensate_pressure(&device->calib, bmp280_adc20(&data[0]), device->t_fine);
+    device->temperature = device->temperature_int / 100.0;
+    device->pressure = device->pressure_int / 256.0;
+}
+
+int bmp280_i2c_read_all(bmp280* device) {
+    uint8_t data[BMP280_DATA_SIZE];
+    int ret = bmp280_i2c_read_reg(device, BMP280_DATA_REG, BMP280_DATA_SIZE, data);
+    if (ret < 0) {
+        return ret;
+    }
+
+    bmp280_compensate_burst(device, data);
+    return ret;
+}
+
 
 
-    adc_t = data[0];
-    adc_t <<= 8;
-    adc_t |= data[1];
-    adc_t <<= 4;
-    adc_t |= (data[2] >> 4);
+/*
+    Asynchronous forced mode sampling
+*/
 
-    var1 = (adc_t/16384.0 - ((int32_t)((device->coefficients[1] << 8) | device->coefficients[0]))/1024.0) *
-           ((int16_t)((device->coefficients[3] << 8) | device->coefficients[2]));
+static uint32_t bmp280_oversampling(const uint8_t osrs) {
+    return osrs == BMP280_OVERSCAN_DISABLE ? 0 : 1u << (osrs > BMP280_OVERSCAN_X16 ? 4 : osrs - 1);
+}
+
+uint32_t bmp280_measurement_time_us(const bmp280* device) {
+    // datasheet section 9.1, maximum measurement time
+    uint32_t time_us = 1250 + 2300 * bmp280_oversampling(device->config.osrs_t);
+    if (device->config.osrs_p != BMP280_OVERSCAN_DISABLE) {
+        time_us += 2300 * bmp280_oversampling(device->config.osrs_p) + 575;
+    }
+    return time_us;
+}
 
-    var2 = (adc_t/131072.0 - ((int16_t)((device->coefficients[1] << 8) | device->coefficients[0]))/8192.0) *
-           (adc_t/131072.0 - ((int16_t)((device->coefficients[1] << 8) | device->coefficients[0]))/8192.0) *
-           ((int16_t)((device->coefficients[5] << 8) | device->coefficients[4]));
+void bmp280_get_timing(const bmp280* device, bmp280_timing* timing) {
+    // t_standby in microseconds, indexed by BMP280_STANDBY_*
+    static const uint32_t standby_us[8] = { 500, 62500, 125000, 250000, 500000, 1000000, 2000000, 4000000 };
+
+    timing->measurement_us = bmp280_measurement_time_us(device);
+    timing->period_us = timing->measurement_us;
+    if (device->config.mode == BMP280_MODE_NORMAL) {
+        timing->period_us += standby_us[device->config.standby & 0x07];
+    }
+    timing->rate_mhz = 1000000000u / timing->period_us;
+}
+
+static void bmp280_sampler_finish(bmp280* device, int result) {
+    device->sampler.state = BMP280_SAMPLER_IDLE;
+    if (device->sampler.done) {
+        device->sampler.done(device, result);
+    }
+}
+
+static void bmp280_sampler_submit(bmp280* device, bmp280_sampler_state state, const uint8_t tx_len, const uint8_t rx_len) {
+    bmp280_sampler* sampler = &device->sampler;
+    sampler->state = state;
+    sampler->xfer.tx_len = tx_len;
+    sampler->xfer.rx_len = rx_len;
+    if (!i2c_bus_submit(&sampler->xfer)) {
+        bmp280_sampler_finish(device, PICO_ERROR_GENERIC);
+    }
+}
+
+static int64_t bmp280_sampler_alarm(alarm_id_t id, void* user_data) {
+    bmp280* device = (bmp280*)user_data;
+    device->sampler.tx[0] = BMP280_STATUS_REG;
+    bmp280_sampler_submit(device, BMP280_SAMPLER_STATUS, 1, 1);
+    return 0;
+}
+
+static void bmp280_sampler_wait(bmp280* device, const uint32_t time_us) {
+    device->sampler.state = BMP280_SAMPLER_WAIT;
+    if (add_alarm_in_us(time_us, bmp280_sampler_alarm, device, true) < 0) {
+        bmp280_sampler_finish(device, PICO_ERROR_GENERIC);
+    }
+}
+
+static void bmp280_sampler_xfer_done(i2c_xfer_t* xfer, int result) {
+    bmp280* device = (bmp280*)xfer->user;
+    bmp280_sampler* sampler = &device->sampler;
+
+    if (result < 0) {
+        bmp280_sampler_finish(device, result);
+        return;
+    }
+
+    switch (sampler->state) {
+    case BMP280_SAMPLER_TRIGGER:
+        sampler->polls = 0;
+        bmp280_sampler_wait(device, bmp280_measurement_time_us(device));
+        break;
+    case BMP280_SAMPLER_STATUS:
+        if (sampler->rx[0] & BMP280_STATUS_MEASURING) {
+            if (++sampler->polls >= BMP280_STATUS_POLL_MAX) {
+                bmp280_sampler_finish(device, PICO_ERROR_TIMEOUT);
+            } else {
+                bmp280_sampler_wait(device, BMP280_STATUS_POLL_US);
+            }
+            break;
+        }
+        sampler->tx[0] = BMP280_DATA_REG;
+        bmp280_sampler_submit(device, BMP280_SAMPLER_DATA, 1, BMP280_DATA_SIZE);
+        break;
+    case BMP280_SAMPLER_DATA:
+        bmp280_compensate_burst(device, sampler->rx);
+        bmp280_sampler_finish(device, result);
+        break;
+    default:
+        break;
+    }
+}
+
+bool bmp280_sample_async(bmp280* device, bmp280_sample_cb done) {
+    bmp280_sampler* sampler = &device->sampler;
+    if (sampler->state != BMP280_SAMPLER_IDLE) {
+        return false;
+    }
+
+    sampler->done = done;
+    sampler->xfer = (i2c_xfer_t){
+        .dev = &device->dev,
+        .tx = sampler->tx,
+        .rx = sampler->rx,
+        .prio = I2C_BUS_PRIO_HIGH,
+        .done = bmp280_sampler_xfer_done,
+        .user = device,
+    };
+    sampler->tx[0] = BMP280_POWER_CTL_REG;
+    sampler->tx[1] = bmp280_ctrl_meas(&device->config, BMP280_MODE_FORCE);
+    bmp280_sampler_submit(device, BMP280_SAMPLER_TRIGGER, 2, 0);
+    return true;
+}
 
-    device->temperature = (var1 + var2) / 5120.0;
-}
\ No newline at end of file
+bool bmp280_sample_busy(const bmp280* device) {
+    return device->sampler.state != BMP280_SAMPLER_IDLE;
+}
+
+
+
+/*
+    Barometric altitude
+*/
+
+// p / p0 in Q24: near sea level one Q16 step would already be 13 cm
+#define BMP280_ALT_RATIO_SHIFT  24
+#define BMP280_ALT_RATIO_MIN    (1u << 22)  // 0.25
+#define BMP280_ALT_STEP_SHIFT   17          // 1/128
+#define BMP280_ALT_ENTRIES      129
+
+// altitude in cm for p / p0 = 0.25 + i / 128
+static const int32_t bmp280_altitude_table[BMP280_ALT_ENTRIES] = {
+    1027909, 1007911, 988398, 969345, 950727, 932523, 914714, 897280,
+    880204, 863471, 847065, 830972, 815179, 799675, 784446, 769484,
+    754777, 740316, 726093, 712097, 698323, 684761, 671404, 658247,
+    645282, 632503, 619904, 607480, 595225, 583134, 571203, 559427,
+    547801, 536322, 524984, 513785, 502720, 491786, 480980, 470298,
+    459737, 449294, 438967, 428752, 418646, 408648, 398754, 388963,
+    379271, 369677, 360178, 350773, 341459, 332234, 323097, 314045,
+    305077, 296192, 287387, 278660, 270011, 261438, 252939, 244513,
+    236159, 227875, 219659, 211511, 203430, 195414, 187461, 179572,
+    171745, 163978, 156270, 148622, 141031, 133497, 126018, 118595,
+    111225, 103908, 96644, 89431, 82269, 75156, 68093, 61078,
+    54110, 47190, 40315, 33486, 26702, 19962, 13265, 6611,
+    0, -6570, -13098, -19586, -26034, -32443, -38813, -45144,
+    -51438, -57694, -63913, -70096, -76243, -82355, -88431, -94473,
+    -100481, -106455, -112396, -118304, -124180, -130023, -135835, -141616,
+    -147365, -153085, -158774, -164433, -170062, -175663, -181234, -186778,
+    -192293,
+};
+
+int32_t bmp280_altitude_cm(const uint32_t pressure, const uint32_t sea_level) {
+    if (sea_level == 0) {
+        return 0;
+    }
+
+    uint64_t ratio = ((uint64_t)pressure << BMP280_ALT_RATIO_SHIFT) / sea_level;
+    uint64_t offset = ratio > BMP280_ALT_RATIO_MIN ? ratio - BMP280_ALT_RATIO_MIN : 0;
+    uint64_t i = offset >> BMP280_ALT_STEP_SHIFT;
+    int64_t frac = (int64_t)(offset & ((1u << BMP280_ALT_STEP_SHIFT) - 1));
+    if (i >= BMP280_ALT_ENTRIES - 1) {
+        return bmp280_altitude_table[BMP280_ALT_ENTRIES - 1];
+    }
+
+    int32_t h0 = bmp280_altitude_table[i];
+    int32_t h1 = bmp280_altitude_table[i + 1];
+    return h0 + (int32_t)(((h1 - h0) * frac) >> BMP280_ALT_STEP_SHIFT);
+}
+
+uint32_t bmp280_sea_level_pressure(const uint32_t pressure, const int32_t altitude_cm) {
+    // inverse lookup: the table decreases with the ratio
+    uint32_t lo = 0;
+    uint32_t hi = BMP280_ALT_ENTRIES - 1;
+    if (altitude_cm >= bmp280_altitude_table[lo]) {
+        hi = lo + 1;
+    } else if (altitude_cm <= bmp280_altitude_table[hi]) {
+        lo = hi - 1;
+    }
+    while (hi - lo > 1) {
+        uint32_t mid = (lo + hi) / 2;
+        if (bmp280_altitude_table[mid] > altitude_cm) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+
+    int32_t h0 = bmp280_altitude_table[lo];
+    int32_t h1 = bmp280_altitude_table[hi];
+    int32_t h = altitude_cm > h0 ? h0 : (altitude_cm < h1 ? h1 : altitude_cm);
+    uint32_t frac = (uint32_t)(((int64_t)(h0 - h) << BMP280_ALT_STEP_SHIFT) / (h0 - h1));
+    uint32_t ratio = BMP280_ALT_RATIO_MIN + (lo << BMP280_ALT_STEP_SHIFT) + frac;
+    return (uint32_t)(((uint64_t)pressure << BMP280_ALT_RATIO_SHIFT) / ratio);
+}
+
+double bmp280_altitude_double(const double pressure, const double sea_level) {
+    return 44330.0 * (1.0 - pow(pressure / sea_level, 1.0 / 5.255));
+}
+
+int32_t bmp280_altitude(const bmp280* device) {
+    return bmp280_altitude_cm(device->pressure_int, device->sea_level);
+}
+
+void bmp280_altitude_calibrate(bmp280* device, const int32_t altitude_cm) {
+    device->sea_level = bmp280_sea_level_pressure(device->pressure_int, altitude_cm);
+}
+
+// Pa/h from the fixed point accumulator, rounded to nearest
+static inline int32_t bmp280_trend_round(const int32_t pa_per_hour) {
+    return (pa_per_hour + (1 << (BMP280_TREND_SHIFT - 1))) >> BMP280_TREND_SHIFT;
+}
+
+int32_t bmp280_trend_update(bmp280_trend* trend, const uint32_t pressure, const uint64_t timestamp_us) {
+    if (!trend->valid) {
+        trend->pressure = (int64_t)pressure << 8;
+        trend->timestamp_us = timestamp_us;
+        trend->pa_per_hour = 0;
+        trend->valid = true;
+        return 0;
+    }
+    if (timestamp_us <= trend->timestamp_us) {
+        return bmp280_trend_round(trend->pa_per_hour);
+    }
+
+    // slope of the smoothed pressure, then smoothed itself; both keep
+    // BMP280_TREND_SHIFT fraction bits so small steady rates do not vanish
+    int64_t smoothed = trend->pressure + ((((int64_t)pressure << 8) - trend->pressure) >> BMP280_TREND_SHIFT);
+    int64_t slope = (((smoothed - trend->pressure) * 3600000000LL) << BMP280_TREND_SHIFT) /
+                    ((int64_t)(timestamp_us - trend->timestamp_us) << 16);
+    trend->pa_per_hour += (int32_t)((slope - trend->pa_per_hour + (1 << (BMP280_TREND_SHIFT - 1))) >>
+                                    BMP280_TREND_SHIFT);
+    trend->pressure = smoothed;
+    trend->timestamp_us = timestamp_us;
+    return bmp280_trend_round(trend->pa_per_hour);
+}
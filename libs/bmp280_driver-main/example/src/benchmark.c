@@ -0,0 +1,101 @@
+#include <stdio.h>
+#include <stdint.h>
+
+#include <hardware/clocks.h>
+#include <pico/stdlib.h>
+
+#include "bmp280_driver.h"
+
+/*
+    Cycles per sample of the double and the integer compensation, and of the
+    pow() and the table based altitude.
+    Runs without a sensor, on the calibration and readings of the datasheet example.
+    At start the table altitude is compared with pow() in 1 Pa steps over the
+    whole table (25.4..126.6 kPa) and over 90..110 kPa.
+*/
+
+#define BENCHMARK_SAMPLES 1000
+
+static const bmp280_calib datasheet_calib = {
+    27504, 26435, -1000,
+    36477, -10685, 3024, 2855, 140, -7, 15500, -14600, 6000
+};
+
+#define DATASHEET_ADC_T 519888
+#define DATASHEET_ADC_P 415148
+
+static volatile int32_t adc_offset;     // keeps the compiler from folding the loops
+static volatile double double_sink;
+static volatile uint32_t int_sink;
+static volatile int32_t altitude_sink;
+
+// worst difference between the table altitude and pow(), in cm, over lo..hi Pa
+static double altitude_worst_error(uint32_t lo, uint32_t hi) {
+    const uint32_t sea_level = (uint32_t)BMP280_SEA_LEVEL_PA << 8;
+    double worst_cm = 0.0;
+    for (uint32_t pressure_pa = lo; pressure_pa <= hi; pressure_pa++) {
+        double error = bmp280_altitude_cm(pressure_pa << 8, sea_level) - 100.0 * bmp280_altitude_double(pressure_pa, BMP280_SEA_LEVEL_PA);
+        if (error < 0) error = -error;
+        if (error > worst_cm) worst_cm = error;
+    }
+    return worst_cm;
+}
+
+static uint32_t benchmark_cycles(uint64_t start_us, uint64_t end_us) {
+    return (uint32_t)((end_us - start_us) * (clock_get_hz(clk_sys) / 1000000) / BENCHMARK_SAMPLES);
+}
+
+int main() {
+
+    stdio_init_all();
+    sleep_ms(2000);
+
+    printf("altitude table: worst error %f cm over 25.4..126.6 kPa, %f cm over 90..110 kPa\n",
+           altitude_worst_error(25400, 126600), altitude_worst_error(90000, 110000));
+
+    for (;;) {
+        uint64_t start = time_us_64();
+        for (int32_t i = 0; i < BENCHMARK_SAMPLES; i++) {
+            double temperature = bmp280_compensate_temperature_double(&datasheet_calib, DATASHEET_ADC_T + adc_offset + i);
+            double_sink = bmp280_compensate_pressure_double(&datasheet_calib, DATASHEET_ADC_P + adc_offset + i, temperature);
+        }
+        uint32_t double_cycles = benchmark_cycles(start, time_us_64());
+
+        start = time_us_64();
+        for (int32_t i = 0; i < BENCHMARK_SAMPLES; i++) {
+            int32_t t_fine;
+            bmp280_compensate_temperature(&datasheet_calib, DATASHEET_ADC_T + adc_offset + i, &t_fine);
+            int_sink = bmp280_compensate_pressure(&datasheet_calib, DATASHEET_ADC_P + adc_offset + i, t_fine);
+        }
+        uint32_t int_cycles = benchmark_cycles(start, time_us_64());
+
+        // altitude over 80..105 kPa
+        const uint32_t sea_level = (uint32_t)BMP280_SEA_LEVEL_PA << 8;
+        start = time_us_64();
+        for (int32_t i = 0; i < BENCHMARK_SAMPLES; i++) {
+            double_sink = bmp280_altitude_double(80000.0 + 25.0 * (i + adc_offset), BMP280_SEA_LEVEL_PA);
+        }
+        uint32_t pow_cycles = benchmark_cycles(start, time_us_64());
+
+        start = time_us_64();
+        for (int32_t i = 0; i < BENCHMARK_SAMPLES; i++) {
+            altitude_sink = bmp280_altitude_cm((uint32_t)(80000 + 25 * (i + adc_offset)) << 8, sea_level);
+        }
+        uint32_t table_cycles = benchmark_cycles(start, time_us_64());
+
+        int32_t t_fine;
+        int32_t temperature = bmp280_compensate_temperature(&datasheet_calib, DATASHEET_ADC_T, &t_fine);
+        uint32_t pressure = bmp280_compensate_pressure(&datasheet_calib, DATASHEET_ADC_P, t_fine);
+        double temperature_double = bmp280_compensate_temperature_double(&datasheet_calib, DATASHEET_ADC_T);
+        double pressure_double = bmp280_compensate_pressure_double(&datasheet_calib, DATASHEET_ADC_P, temperature_double);
+
+        printf("bmp280 double:  %lu cycles/sample, %f degC %f Pa\n", (unsigned long)double_cycles, temperature_double, pressure_double);
+        printf("bmp280 integer: %lu cycles/sample, %ld.%02ld degC %f Pa\n", (unsigned long)int_cycles,
+               (long)(temperature / 100), (long)(temperature % 100), pressure / 256.0);
+        printf("altitude pow(): %lu cycles/sample\n", (unsigned long)pow_cycles);
+        printf("altitude table: %lu cycles/sample\n", (unsigned long)table_cycles);
+        sleep_ms(1000);
+    }
+
+    return 0;
+}
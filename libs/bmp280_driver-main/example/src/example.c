@@ -15,13 +15,20 @@ int main() {
     gpio_set_function(5, GPIO_FUNC_I2C);
     gpio_pull_up(4);
     gpio_pull_up(5);
+    i2c_bus_t bus;
+    i2c_bus_init(&bus, BMP280_DEFAULT_I2C_PORT, false);
     bmp280 bmp280_device = { 0 };
-    bmp280_i2c_setup();
+    bmp280_i2c_init(&bmp280_device, &bus, BMP280_I2C_ADDRESS);
+    bmp280_i2c_setup(&bmp280_device);
     bmp280_i2c_calibrate(&bmp280_device);
+    bmp280_i2c_set_profile(&bmp280_device, BMP280_PROFILE_HIGH_RESOLUTION);
+
+    bmp280_timing timing;
+    bmp280_get_timing(&bmp280_device, &timing);
+    printf("bmp280 measurement: %lu us, max rate: %lu mHz\n", (unsigned long)timing.measurement_us, (unsigned long)timing.rate_mhz);
 
     for (;;) {
-        bmp280_i2c_read_temperature(&bmp280_device);
-        bmp280_i2c_read_pressure(&bmp280_device);
+        bmp280_i2c_read_all(&bmp280_device);
         printf("bmp280 temperature: %f\n", bmp280_device.temperature);
         printf("bmp280 pressure: %f\n", bmp280_device.pressure);
         sleep_ms(1000);
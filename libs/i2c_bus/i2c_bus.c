@@ -0,0 +1,311 @@
+#include "i2c_bus.h"
+
+#include "pico/stdlib.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+
+// Barramentos com escalonador ativo, indexados pela instância I2C
+static i2c_bus_t *active_buses[2];
+static bool dma_irq_installed;  // Handler compartilhado de DMA_IRQ_1 já registrado
+
+static inline uint i2c_bus_index(i2c_inst_t *i2c) {
+    return i2c == i2c0 ? 0 : 1;
+}
+
+// Gera a palavra de comando de índice "i" da transação atual:
+// bytes do prefixo, bytes de tx e, por fim, comandos de leitura.
+// Escritas de 8 bits em IC_DATA_CMD são replicadas nos bits de comando
+// (CMD/STOP/RESTART), por isso o DMA sempre escreve palavras de 16 bits.
+static inline uint16_t i2c_bus_word(const i2c_bus_t *bus, size_t i) {
+    const i2c_xfer_t *x = bus->current;
+    uint16_t word;
+    if (i < x->prefix_len) {
+        word = x->prefix[i];
+    } else if (i < x->prefix_len + x->tx_len) {
+        word = x->tx[i - x->prefix_len];
+    } else {
+        word = I2C_IC_DATA_CMD_CMD_BITS;
+        // O primeiro comando de leitura após uma escrita gera repeated start
+        if (i == x->prefix_len + x->tx_len && i > 0) {
+            word |= I2C_IC_DATA_CMD_RESTART_BITS;
+        }
+    }
+    if (i == bus->total - 1) {
+        word |= I2C_IC_DATA_CMD_STOP_BITS;
+    }
+    return word;
+}
+
+// Prepara o próximo bloco de palavras e dispara o DMA de transmissão
+static void i2c_bus_feed(i2c_bus_t *bus) {
+    size_t count = bus->total - bus->pos;
+    if (count > I2C_BUS_CHUNK_WORDS) {
+        count = I2C_BUS_CHUNK_WORDS;
+    }
+    for (size_t i = 0; i < count; i++) {
+        bus->words[i] = i2c_bus_word(bus, bus->pos + i);
+    }
+    bus->pos += count;
+    dma_channel_transfer_from_buffer_now(bus->dma_tx, bus->words, count);
+}
+
+// Inicia a próxima transação da fila; chamada com interrupções desabilitadas ou em IRQ
+static void i2c_bus_start_next(i2c_bus_t *bus) {
+    i2c_hw_t *hw = i2c_get_hw(bus->i2c);
+    i2c_xfer_t *x = NULL;
+
+    for (int prio = 0; prio < I2C_BUS_PRIO_COUNT && !x; prio++) {
+        x = bus->head[prio];
+        if (x) {
+            bus->head[prio] = x->next;
+            if (!bus->head[prio]) {
+                bus->tail[prio] = NULL;
+            }
+        }
+    }
+
+    bus->current = x;
+    if (!x) {
+        // Barramento ocioso: sem interrupções nem DMA, as funções bloqueantes do SDK continuam válidas
+        hw->intr_mask = 0;
+        hw->dma_cr = 0;
+        return;
+    }
+
+    bus->pos = 0;
+    bus->total = x->prefix_len + x->tx_len + x->rx_len;
+    bus->aborted = false;
+
+    hw->enable = 0;
+    hw->tar = x->dev->address;
+    hw->enable = 1;
+    (void)hw->clr_tx_abrt;
+    (void)hw->clr_stop_det;
+
+    if (x->rx_len) {
+        dma_channel_config c = dma_channel_get_default_config(bus->dma_rx);
+        channel_config_set_transfer_data_size(&c, DMA_SIZE_8);
+        channel_config_set_read_increment(&c, false);
+        channel_config_set_write_increment(&c, true);
+        channel_config_set_dreq(&c, i2c_get_dreq(bus->i2c, false));
+        dma_channel_configure(bus->dma_rx, &c, x->rx, &hw->data_cmd, x->rx_len, true);
+    }
+
+    hw->dma_cr = I2C_IC_DMA_CR_TDMAE_BITS | (x->rx_len ? I2C_IC_DMA_CR_RDMAE_BITS : 0);
+    hw->intr_mask = I2C_IC_INTR_MASK_M_STOP_DET_BITS | I2C_IC_INTR_MASK_M_TX_ABRT_BITS;
+    i2c_bus_feed(bus);
+}
+
+static void i2c_bus_finish(i2c_bus_t *bus) {
+    i2c_xfer_t *x = bus->current;
+
+    if (x->rx_len) {
+        if (bus->aborted) {
+            dma_channel_abort(bus->dma_rx);
+        } else {
+            // O último byte chega antes do STOP; o DMA só precisa esvaziar a FIFO
+            dma_channel_wait_for_finish_blocking(bus->dma_rx);
+        }
+    }
+
+    x->result = bus->aborted ? I2C_BUS_ERROR_ABORT : (int)(x->prefix_len + x->tx_len + x->rx_len);
+    x->busy = false;
+    if (x->done) {
+        x->done(x, x->result);
+    }
+    i2c_bus_start_next(bus);
+}
+
+static void i2c_bus_irq(i2c_bus_t *bus) {
+    i2c_hw_t *hw = i2c_get_hw(bus->i2c);
+    uint32_t stat = hw->intr_stat;
+
+    if (stat & I2C_IC_INTR_STAT_R_TX_ABRT_BITS) {
+        // NACK: o controlador descarta a FIFO e gera STOP; interrompe o DMA sem disparar sua IRQ
+        bus->aborted = true;
+        dma_channel_set_irq1_enabled(bus->dma_tx, false);
+        dma_channel_abort(bus->dma_tx);
+        dma_channel_acknowledge_irq1(bus->dma_tx);
+        dma_channel_set_irq1_enabled(bus->dma_tx, true);
+        (void)hw->clr_tx_abrt;
+    }
+    if (stat & I2C_IC_INTR_STAT_R_STOP_DET_BITS) {
+        (void)hw->clr_stop_det;
+        if (bus->current) {
+            i2c_bus_finish(bus);
+        }
+    }
+}
+
+static void i2c_bus_irq0(void) {
+    i2c_bus_irq(active_buses[0]);
+}
+
+static void i2c_bus_irq1(void) {
+    i2c_bus_irq(active_buses[1]);
+}
+
+// IRQ de DMA compartilhada: reabastece o DMA de transmissão de cada barramento ativo
+static void i2c_bus_dma_irq(void) {
+    for (int i = 0; i < 2; i++) {
+        i2c_bus_t *bus = active_buses[i];
+        if (!bus || !dma_channel_get_irq1_status(bus->dma_tx)) {
+            continue;
+        }
+        dma_channel_acknowledge_irq1(bus->dma_tx);
+        if (bus->current && !bus->aborted && bus->pos < bus->total) {
+            i2c_bus_feed(bus);
+        }
+    }
+}
+
+bool i2c_bus_init(i2c_bus_t *bus, i2c_inst_t *i2c, bool async) {
+    uint idx = i2c_bus_index(i2c);
+
+    bus->i2c = i2c;
+    bus->async = false;
+    bus->current = NULL;
+    for (int prio = 0; prio < I2C_BUS_PRIO_COUNT; prio++) {
+        bus->head[prio] = bus->tail[prio] = NULL;
+    }
+    if (!async) {
+        return true;
+    }
+    if (active_buses[idx]) {
+        return false;  // Já existe um escalonador para esta instância
+    }
+
+    bus->dma_tx = dma_claim_unused_channel(false);
+    bus->dma_rx = dma_claim_unused_channel(false);
+    if (bus->dma_tx < 0 || bus->dma_rx < 0) {
+        if (bus->dma_tx >= 0) dma_channel_unclaim(bus->dma_tx);
+        if (bus->dma_rx >= 0) dma_channel_unclaim(bus->dma_rx);
+        return false;
+    }
+
+    i2c_hw_t *hw = i2c_get_hw(i2c);
+    dma_channel_config c = dma_channel_get_default_config(bus->dma_tx);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, i2c_get_dreq(i2c, true));
+    dma_channel_configure(bus->dma_tx, &c, &hw->data_cmd, bus->words, 0, false);
+
+    // Pede dados ao DMA com a FIFO de transmissão pela metade, evitando pausas no barramento
+    hw->dma_tdlr = 8;
+    hw->dma_rdlr = 0;
+    hw->intr_mask = 0;
+
+    active_buses[idx] = bus;
+    bus->async = true;
+
+    if (!dma_irq_installed) {
+        irq_add_shared_handler(DMA_IRQ_1, i2c_bus_dma_irq, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+        dma_irq_installed = true;
+    }
+    dma_channel_set_irq1_enabled(bus->dma_tx, true);
+    irq_set_enabled(DMA_IRQ_1, true);
+
+    irq_set_exclusive_handler(I2C0_IRQ + idx, idx ? i2c_bus_irq1 : i2c_bus_irq0);
+    irq_set_enabled(I2C0_IRQ + idx, true);
+    return true;
+}
+
+bool i2c_bus_submit(i2c_xfer_t *xfer) {
+    i2c_bus_t *bus = xfer->dev->bus;
+    if (xfer->busy || (xfer->prefix_len + xfer->tx_len + xfer->rx_len) == 0) {
+        return false;
+    }
+
+    if (!bus->async) {
+        // Sem escalonador: executa imediatamente com as funções do SDK (que não enviam prefixo e dados juntos)
+        if (xfer->prefix_len) {
+            return false;
+        }
+        xfer->busy = true;
+        if (xfer->rx_len) {
+            xfer->result = i2c_dev_write_read_blocking(xfer->dev, xfer->tx, xfer->tx_len, xfer->rx, xfer->rx_len);
+        } else {
+            xfer->result = i2c_dev_write_blocking(xfer->dev, xfer->tx, xfer->tx_len);
+        }
+        xfer->busy = false;
+        if (xfer->done) {
+            xfer->done(xfer, xfer->result);
+        }
+        return true;
+    }
+
+    xfer->busy = true;
+    xfer->next = NULL;
+
+    uint32_t irq = save_and_disable_interrupts();
+    i2c_bus_prio_t prio = xfer->prio < I2C_BUS_PRIO_COUNT ? xfer->prio : I2C_BUS_PRIO_LOW;
+    if (bus->tail[prio]) {
+        bus->tail[prio]->next = xfer;
+    } else {
+        bus->head[prio] = xfer;
+    }
+    bus->tail[prio] = xfer;
+    if (!bus->current) {
+        i2c_bus_start_next(bus);
+    }
+    restore_interrupts(irq);
+    return true;
+}
+
+int i2c_bus_transfer_blocking(i2c_xfer_t *xfer) {
+    if (!i2c_bus_submit(xfer)) {
+        return PICO_ERROR_GENERIC;
+    }
+    while (xfer->busy) {
+        tight_loop_contents();
+    }
+    return xfer->result;
+}
+
+bool i2c_bus_idle(const i2c_bus_t *bus) {
+    if (!bus->async) {
+        return true;
+    }
+    for (int prio = 0; prio < I2C_BUS_PRIO_COUNT; prio++) {
+        if (bus->head[prio]) {
+            return false;
+        }
+    }
+    return bus->current == NULL;
+}
+
+int i2c_dev_write_blocking(const i2c_dev_t *dev, const uint8_t *src, size_t len) {
+    if (!dev->bus->async) {
+        return i2c_write_blocking(dev->bus->i2c, dev->address, src, len, false);
+    }
+    i2c_xfer_t xfer = {
+        .dev = dev,
+        .tx = src,
+        .tx_len = len,
+        .prio = I2C_BUS_PRIO_HIGH,
+    };
+    return i2c_bus_transfer_blocking(&xfer);
+}
+
+int i2c_dev_write_read_blocking(const i2c_dev_t *dev, const uint8_t *tx, size_t tx_len, uint8_t *rx, size_t rx_len) {
+    if (!dev->bus->async) {
+        if (tx_len) {
+            int ret = i2c_write_blocking(dev->bus->i2c, dev->address, tx, tx_len, true);
+            if (ret < 0) {
+                return ret;
+            }
+        }
+        return i2c_read_blocking(dev->bus->i2c, dev->address, rx, rx_len, false);
+    }
+    i2c_xfer_t xfer = {
+        .dev = dev,
+        .tx = tx,
+        .tx_len = tx_len,
+        .rx = rx,
+        .rx_len = rx_len,
+        .prio = I2C_BUS_PRIO_HIGH,
+    };
+    return i2c_bus_transfer_blocking(&xfer);
+}
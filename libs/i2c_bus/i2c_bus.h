@@ -0,0 +1,94 @@
+#ifndef I2C_BUS_H
+#define I2C_BUS_H
+
+// Escalonador de transações I2C não bloqueante, uma fila por barramento.
+//
+// Cada transação (i2c_xfer_t) é enviada por DMA e acompanhada por
+// interrupções do controlador I2C; ao terminar, o callback da transação é
+// chamado em contexto de interrupção. Transações de prioridade alta (leituras
+// de sensores) são atendidas antes das de prioridade baixa (dados do display),
+// mas uma transação em andamento nunca é interrompida.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "hardware/i2c.h"
+
+// Palavras de comando preparadas por vez para o DMA de transmissão
+#define I2C_BUS_CHUNK_WORDS 32
+
+// Resultado de uma transação abortada (endereço ou dado sem ACK)
+#define I2C_BUS_ERROR_ABORT -1
+
+typedef enum {
+    I2C_BUS_PRIO_HIGH = 0,  // Leituras de sensores e comandos curtos
+    I2C_BUS_PRIO_LOW = 1,   // Transferências longas (framebuffer do display)
+    I2C_BUS_PRIO_COUNT
+} i2c_bus_prio_t;
+
+typedef struct i2c_bus i2c_bus_t;
+typedef struct i2c_xfer i2c_xfer_t;
+
+// Identifica um dispositivo: barramento + endereço de 7 bits
+typedef struct {
+    i2c_bus_t *bus;
+    uint8_t address;
+} i2c_dev_t;
+
+// Chamado em contexto de interrupção quando a transação termina;
+// result é o número de bytes transferidos ou I2C_BUS_ERROR_ABORT
+typedef void (*i2c_xfer_cb_t)(i2c_xfer_t *xfer, int result);
+
+// Descritor de transação: escreve prefix, depois tx, e então (com repeated
+// start) lê rx_len bytes em rx. A memória do descritor e dos buffers pertence
+// a quem submeteu e deve permanecer válida até o callback.
+struct i2c_xfer {
+    const i2c_dev_t *dev;
+    const uint8_t *prefix;     // Bytes enviados antes de tx (ex.: cabeçalho de comandos), pode ser NULL
+    size_t prefix_len;
+    const uint8_t *tx;         // Dados a escrever, pode ser NULL
+    size_t tx_len;
+    uint8_t *rx;               // Destino da leitura, pode ser NULL
+    size_t rx_len;
+    i2c_bus_prio_t prio;
+    i2c_xfer_cb_t done;        // Callback de conclusão, pode ser NULL
+    void *user;                // Dado livre para o callback
+    volatile bool busy;        // Verdadeiro enquanto na fila ou em andamento
+    volatile int result;       // Resultado após a conclusão
+    i2c_xfer_t *next;          // Uso interno (fila)
+};
+
+// Estado de um barramento; não deve ser acessado diretamente
+struct i2c_bus {
+    i2c_inst_t *i2c;
+    bool async;                            // Escalonador ativo (DMA + interrupções)
+    int dma_tx;                            // Canal DMA de transmissão (palavras de comando)
+    int dma_rx;                            // Canal DMA de recepção
+    i2c_xfer_t *head[I2C_BUS_PRIO_COUNT];  // Filas por prioridade
+    i2c_xfer_t *tail[I2C_BUS_PRIO_COUNT];
+    i2c_xfer_t *current;                   // Transação em andamento
+    size_t pos;                            // Próxima palavra de comando da transação atual
+    size_t total;                          // Total de palavras da transação atual
+    bool aborted;                          // A transação atual recebeu NACK
+    uint16_t words[I2C_BUS_CHUNK_WORDS];   // Palavras enviadas ao registrador IC_DATA_CMD
+};
+
+// Inicializa o barramento (a instância já deve ter passado por i2c_init()).
+// Com async = false todas as transações usam as funções bloqueantes do SDK.
+bool i2c_bus_init(i2c_bus_t *bus, i2c_inst_t *i2c, bool async);
+
+// Enfileira uma transação; retorna false se o descritor já estiver em uso.
+// Sem escalonador a transação é executada na hora e prefix não é suportado.
+bool i2c_bus_submit(i2c_xfer_t *xfer);
+
+// Enfileira e aguarda a conclusão; não deve ser chamada em interrupções
+int i2c_bus_transfer_blocking(i2c_xfer_t *xfer);
+
+// Retorna true se não há transação em andamento nem na fila
+bool i2c_bus_idle(const i2c_bus_t *bus);
+
+// Atalhos bloqueantes para drivers: escrita simples e escrita seguida de leitura
+int i2c_dev_write_blocking(const i2c_dev_t *dev, const uint8_t *src, size_t len);
+int i2c_dev_write_read_blocking(const i2c_dev_t *dev, const uint8_t *tx, size_t tx_len, uint8_t *rx, size_t rx_len);
+
+#endif // I2C_BUS_H
@@ -19,26 +19,91 @@
 #define MEM_LIBC_MALLOC             0
 #endif
 #define MEM_ALIGNMENT               4
+
+// Memory profiles, selected with -DLWIP_PROFILE=<profile> (CMake cache variable LWIP_PROFILE):
+//   LWIP_PROFILE_MINIMAL     2-segment windows and small pools, for the smallest RAM footprint
+//   LWIP_PROFILE_DEFAULT     the sizing of the pico_w examples
+//   LWIP_PROFILE_THROUGHPUT  16-segment windows and pools to match, for bulk transfers
+// Check the high-water marks exported by net_stats (GET /net) against these limits.
+// The values start at 1 so that a misspelled profile, which the preprocessor
+// evaluates as 0, hits the #error below instead of silently selecting one.
+#define LWIP_PROFILE_MINIMAL        1
+#define LWIP_PROFILE_DEFAULT        2
+#define LWIP_PROFILE_THROUGHPUT     3
+#ifndef LWIP_PROFILE
+#define LWIP_PROFILE                LWIP_PROFILE_DEFAULT
+#endif
+
+// Every tcp_write in this firmware copies into the heap (TCP_WRITE_FLAG_COPY), so
+// MEM_SIZE, not TCP_SND_BUF, is what bounds the unacknowledged data in flight.
+// minimal and default keep a heap smaller than the send buffer: no request or
+// event is larger than ~1.7 KB and a full heap fails tcp_write with ERR_MEM, which
+// the HTTP client and live server already treat as backpressure. throughput is
+// meant to fill the send buffer, so its heap holds a full TCP_SND_BUF plus the
+// default heap as headroom for the other connections and UDP.
+//
+// Spare sys_timeout slots and UDP PCBs on top of what the firmware itself uses
+// (LWIP_APP_SYS_TIMEOUTS below; UDP: DHCP, DNS, telemetry and SNTP) leave room
+// for experiments; minimal has none, so every new user must raise the counts.
+
+#define TCP_MSS                     1460
+#if LWIP_PROFILE == LWIP_PROFILE_MINIMAL
+#define LWIP_PROFILE_NAME           "minimal"
+#define MEM_SIZE                    3000
+#define MEMP_NUM_TCP_SEG            16
+#define PBUF_POOL_SIZE              8
+#define TCP_WND                     (2 * TCP_MSS)
+#define TCP_SND_BUF                 (2 * TCP_MSS)
+#define LWIP_SPARE_SYS_TIMEOUTS     0
+#define MEMP_NUM_UDP_PCB            4
+#elif LWIP_PROFILE == LWIP_PROFILE_THROUGHPUT
+#define LWIP_PROFILE_NAME           "throughput"
+#define MEMP_NUM_TCP_SEG            64
+#define PBUF_POOL_SIZE              32
+#define TCP_WND                     (16 * TCP_MSS)
+#define TCP_SND_BUF                 (16 * TCP_MSS)
+#define MEM_SIZE                    (TCP_SND_BUF + 4000)
+#define LWIP_SPARE_SYS_TIMEOUTS     4
+#define MEMP_NUM_UDP_PCB            8
+#elif LWIP_PROFILE == LWIP_PROFILE_DEFAULT
+#define LWIP_PROFILE_NAME           "default"
 #define MEM_SIZE                    4000
 #define MEMP_NUM_TCP_SEG            32
-#define MEMP_NUM_ARP_QUEUE          10
 #define PBUF_POOL_SIZE              24
+#define TCP_WND                     (8 * TCP_MSS)
+#define TCP_SND_BUF                 (8 * TCP_MSS)
+#define LWIP_SPARE_SYS_TIMEOUTS     2
+#define MEMP_NUM_UDP_PCB            6
+#else
+#error "Unknown LWIP_PROFILE: use LWIP_PROFILE_MINIMAL, LWIP_PROFILE_DEFAULT or LWIP_PROFILE_THROUGHPUT"
+#endif
+#define TCP_SND_QUEUELEN            ((4 * (TCP_SND_BUF) + (TCP_MSS - 1)) / (TCP_MSS))
+
+// HTTP client, live server clients (LIVE_SERVER_MAX_CLIENTS) and connections in TIME_WAIT
+#define MEMP_NUM_TCP_PCB            8
+
+// Timers armed with sys_timeout() outside lwIP, at most one pending per module:
+//   http_client   request deadline
+//   result_queue  batch upload interval
+//   telemetry     retransmission check
+//   result_log    forwarding of stored rounds
+//   wifi_link     association poll or reconnect backoff
+//   live_server   stream heartbeat
+//   net_clock     SNTP poll or retry
+#define LWIP_APP_SYS_TIMEOUTS       7
+// lwIP's default pool only fits its own timers (LWIP_NUM_SYS_TIMEOUT_INTERNAL);
+// with it full, sys_timeout() asserts and the timer is never armed
+#define MEMP_NUM_SYS_TIMEOUT        (LWIP_NUM_SYS_TIMEOUT_INTERNAL + LWIP_APP_SYS_TIMEOUTS + LWIP_SPARE_SYS_TIMEOUTS)
+
+#define MEMP_NUM_ARP_QUEUE          10
 #define LWIP_ARP                    1
 #define LWIP_ETHERNET               1
 #define LWIP_ICMP                   1
 #define LWIP_RAW                    1
-#define TCP_WND                     (8 * TCP_MSS)
-#define TCP_MSS                     1460
-#define TCP_SND_BUF                 (8 * TCP_MSS)
-#define TCP_SND_QUEUELEN            ((4 * (TCP_SND_BUF) + (TCP_MSS - 1)) / (TCP_MSS))
 #define LWIP_NETIF_STATUS_CALLBACK  1
 #define LWIP_NETIF_LINK_CALLBACK    1
 #define LWIP_NETIF_HOSTNAME         1
 #define LWIP_NETCONN                0
-#define MEM_STATS                   0
-#define SYS_STATS                   0
-#define MEMP_STATS                  0
-#define LINK_STATS                  0
 // #define ETH_PAD_SIZE                2
 #define LWIP_CHKSUM_ALGORITHM       3
 #define LWIP_DHCP                   1
@@ -51,9 +116,16 @@
 #define DHCP_DOES_ARP_CHECK         0
 #define LWIP_DHCP_DOES_ACD_CHECK    0
 
+// Heap and pool counters (usage, high-water mark, allocation failures) are kept in
+// every build for net_stats; dumping them to stdout stays a debug-only feature
+#define LWIP_STATS                  1
+#define MEM_STATS                   1
+#define MEMP_STATS                  1
+#define SYS_STATS                   0
+#define LINK_STATS                  0
+
 #ifndef NDEBUG
 #define LWIP_DEBUG                  1
-#define LWIP_STATS                  1
 #define LWIP_STATS_DISPLAY          1
 #endif
 
@@ -34,13 +34,15 @@ SOFTWARE.
 #include "font.h"
 
 inline static void swap(int32_t *a, int32_t *b) {
-    int32_t *t=a;
+    int32_t t=*a;
     *a=*b;
-    *b=*t;
+    *b=t;
 }
 
-inline static void fancy_write(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, char *name) {
-    switch(i2c_write_blocking(i2c, addr, src, len, false)) {
+inline static void fancy_write(ssd1306_t *p, const uint8_t *src, size_t len, char *name) {
+    int ret=p->write_fn?p->write_fn(p->write_ctx, src, len):i2c_write_blocking(p->i2c_i, p->address, src, len, false);
+
+    switch(ret) {
     case PICO_ERROR_GENERIC:
         printf("[%s] addr not acknowledged!\n", name);
         break;
@@ -55,7 +57,57 @@ inline static void fancy_write(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src
 
 inline static void ssd1306_write(ssd1306_t *p, uint8_t val) {
     uint8_t d[2]= {0x00, val};
-    fancy_write(p->i2c_i, p->address, d, 2, "ssd1306_write");
+    fancy_write(p, d, 2, "ssd1306_write");
+}
+
+inline void ssd1306_cmd_list_init(ssd1306_cmd_list_t *l) {
+    l->buf[0]=0x00; // Co=0, D/C#=0: every following byte is a command
+    l->len=0;
+}
+
+bool ssd1306_cmd_list_add(ssd1306_cmd_list_t *l, uint8_t cmd) {
+    if(l->len>=SSD1306_CMD_LIST_MAX)
+        return false;
+
+    l->buf[++(l->len)]=cmd;
+    return true;
+}
+
+void ssd1306_cmd_list_send(ssd1306_t *p, ssd1306_cmd_list_t *l) {
+    if(l->len)
+        fancy_write(p, l->buf, l->len+1, "ssd1306_cmd_list_send");
+
+    ssd1306_cmd_list_init(l);
+}
+
+void ssd1306_write_cmds(ssd1306_t *p, const uint8_t *cmds, size_t len) {
+    ssd1306_cmd_list_t l;
+    ssd1306_cmd_list_init(&l);
+
+    for(size_t i=0; i<len; ++i) {
+        if(!ssd1306_cmd_list_add(&l, cmds[i])) {
+            ssd1306_cmd_list_send(p, &l);
+            ssd1306_cmd_list_add(&l, cmds[i]);
+        }
+    }
+
+    ssd1306_cmd_list_send(p, &l);
+}
+
+void ssd1306_window_header(ssd1306_t *p, uint8_t *hdr, uint8_t col_start, uint8_t col_end, uint8_t page_start, uint8_t page_end) {
+    if(p->width==64) {
+        col_start+=32;
+        col_end+=32;
+    }
+
+    const uint8_t cmds[]= {SET_COL_ADDR, col_start, col_end, SET_PAGE_ADDR, page_start, page_end};
+
+    for(size_t i=0; i<sizeof(cmds); ++i) {
+        *(hdr++)=0x80; // Co=1, D/C#=0: one command byte, another control byte follows
+        *(hdr++)=cmds[i];
+    }
+
+    *hdr=0x40; // Co=0, D/C#=1: data until stop condition
 }
 
 bool ssd1306_init(ssd1306_t *p, uint16_t width, uint16_t height, uint8_t address, i2c_inst_t *i2c_instance) {
@@ -65,15 +117,17 @@ bool ssd1306_init(ssd1306_t *p, uint16_t width, uint16_t height, uint8_t address
     p->address=address;
 
     p->i2c_i=i2c_instance;
+    p->write_fn=NULL;
+    p->write_ctx=NULL;
 
 
     p->bufsize=(p->pages)*(p->width);
-    if((p->buffer=malloc(p->bufsize+1))==NULL) {
+    if((p->buffer=malloc(p->bufsize+SSD1306_ADDR_HEADER_SIZE))==NULL) {
         p->bufsize=0;
         return false;
     }
 
-    ++(p->buffer);
+    p->buffer+=SSD1306_ADDR_HEADER_SIZE;
 
     // from https://github.com/makerportal/rpi-pico-ssd1306
     uint8_t cmds[]= {
@@ -109,14 +163,18 @@ bool ssd1306_init(ssd1306_t *p, uint16_t width, uint16_t height, uint8_t address
         0x00,  // horizontal
     };
 
-    for(size_t i=0; i<sizeof(cmds); ++i)
-        ssd1306_write(p, cmds[i]);
+    ssd1306_write_cmds(p, cmds, sizeof(cmds));
 
     return true;
 }
 
+inline void ssd1306_set_write_fn(ssd1306_t *p, ssd1306_write_fn fn, void *ctx) {
+    p->write_fn=fn;
+    p->write_ctx=ctx;
+}
+
 inline void ssd1306_deinit(ssd1306_t *p) {
-    free(p->buffer-1);
+    free(p->buffer-SSD1306_ADDR_HEADER_SIZE);
 }
 
 inline void ssd1306_poweroff(ssd1306_t *p) {
@@ -128,14 +186,56 @@ inline void ssd1306_poweron(ssd1306_t *p) {
 }
 
 inline void ssd1306_contrast(ssd1306_t *p, uint8_t val) {
-    ssd1306_write(p, SET_CONTRAST);
-    ssd1306_write(p, val);
+    const uint8_t cmds[]= {SET_CONTRAST, val};
+    ssd1306_write_cmds(p, cmds, sizeof(cmds));
 }
 
 inline void ssd1306_invert(ssd1306_t *p, uint8_t inv) {
     ssd1306_write(p, SET_NORM_INV | (inv & 1));
 }
 
+void ssd1306_scroll_horizontal(ssd1306_t *p, ssd1306_scroll_dir_t dir, uint8_t start_page, uint8_t end_page, ssd1306_scroll_speed_t speed) {
+    // scrolling has to be off while it is configured
+    const uint8_t cmds[]= {
+        SET_SCROLL_OFF,
+        dir==SSD1306_SCROLL_LEFT?SET_SCROLL_LEFT:SET_SCROLL_RIGHT,
+        0x00,                   // dummy
+        start_page&7,
+        speed&7,
+        end_page&7,
+        0x00,                   // dummy
+        0xFF,                   // dummy
+        SET_SCROLL_ON
+    };
+    ssd1306_write_cmds(p, cmds, sizeof(cmds));
+}
+
+void ssd1306_scroll_diagonal(ssd1306_t *p, ssd1306_scroll_dir_t dir, uint8_t start_page, uint8_t end_page, ssd1306_scroll_speed_t speed, uint8_t vertical_offset) {
+    const uint8_t cmds[]= {
+        SET_SCROLL_OFF,
+        SET_VERT_SCROLL_AREA,   // whole display scrolls vertically
+        0x00,
+        p->height,
+        dir==SSD1306_SCROLL_LEFT?SET_SCROLL_VERT_LEFT:SET_SCROLL_VERT_RIGHT,
+        0x00,                   // dummy
+        start_page&7,
+        speed&7,
+        end_page&7,
+        vertical_offset&0x3F,
+        SET_SCROLL_ON
+    };
+    ssd1306_write_cmds(p, cmds, sizeof(cmds));
+}
+
+inline void ssd1306_scroll_stop(ssd1306_t *p) {
+    ssd1306_write(p, SET_SCROLL_OFF);
+}
+
+inline void ssd1306_fade(ssd1306_t *p, ssd1306_fade_mode_t mode, uint8_t interval) {
+    const uint8_t cmds[]= {SET_FADE_BLINK, mode|(interval&0x0F)};
+    ssd1306_write_cmds(p, cmds, sizeof(cmds));
+}
+
 inline void ssd1306_clear(ssd1306_t *p) {
     memset(p->buffer, 0, p->bufsize);
 }
@@ -152,45 +252,129 @@ void ssd1306_draw_pixel(ssd1306_t *p, uint32_t x, uint32_t y) {
     p->buffer[x+p->width*(y>>3)]|=0x1<<(y&0x07); // y>>3==y/8 && y&0x7==y%8
 }
 
+/*
+ * sets (or clears) a clipped rectangle page by page: partial pages are
+ * masked byte by byte, full pages are memset as one run
+ */
+static void ssd1306_fill_rect(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, uint32_t height, bool set) {
+    if(x>=p->width || y>=p->height || !width || !height)
+        return;
+
+    if(width>p->width-x)
+        width=p->width-x;
+    if(height>p->height-y)
+        height=p->height-y;
+
+    uint32_t y_end=y+height;
+    for(uint32_t page=y>>3; (page<<3)<y_end; ++page) {
+        uint32_t top=(page<<3)<y?y&7:0;
+        uint32_t bottom=((page+1)<<3)>y_end?y_end&7:8;
+        uint8_t mask=(uint8_t) ((0xff<<top)&(0xff>>(8-bottom)));
+        uint8_t *dst=p->buffer+x+p->width*page;
+
+        if(mask==0xff)
+            memset(dst, set?0xff:0x00, width);
+        else if(set)
+            for(uint32_t i=0; i<width; ++i)
+                dst[i]|=mask;
+        else
+            for(uint32_t i=0; i<width; ++i)
+                dst[i]&=~mask;
+    }
+}
+
+void ssd1306_draw_hline(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width) {
+    ssd1306_fill_rect(p, x, y, width, 1, true);
+}
+
+void ssd1306_draw_vline(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t height) {
+    ssd1306_fill_rect(p, x, y, 1, height, true);
+}
+
 void ssd1306_draw_line(ssd1306_t *p, int32_t x1, int32_t y1, int32_t x2, int32_t y2) {
     if(x1>x2) {
         swap(&x1, &x2);
         swap(&y1, &y2);
     }
 
+    if(y1==y2) {
+        if(y1>=0 && x2>=0)
+            ssd1306_draw_hline(p, x1<0?0:x1, y1, x2-(x1<0?0:x1)+1);
+        return;
+    }
+
     if(x1==x2) {
         if(y1>y2)
             swap(&y1, &y2);
-        for(int32_t i=y1; i<=y2; ++i)
-            ssd1306_draw_pixel(p, x1, i);
+        if(x1>=0 && y2>=0)
+            ssd1306_draw_vline(p, x1, y1<0?0:y1, y2-(y1<0?0:y1)+1);
         return;
     }
 
-    float m=(float) (y2-y1) / (float) (x2-x1);
+    // bresenham, integer only
+    int32_t dx=x2-x1;
+    int32_t dy=y2>y1?y2-y1:y1-y2;
+    int32_t sy=y2>y1?1:-1;
+    int32_t err=dx-dy;
 
-    for(int32_t i=x1; i<=x2; ++i) {
-        float y=m*(float) (i-x1)+(float) y1;
-        ssd1306_draw_pixel(p, i, (uint32_t) y);
+    for(;;) {
+        ssd1306_draw_pixel(p, (uint32_t) x1, (uint32_t) y1);
+        if(x1==x2 && y1==y2)
+            break;
+
+        int32_t e2=2*err;
+        if(e2>-dy) {
+            err-=dy;
+            ++x1;
+        }
+        if(e2<dx) {
+            err+=dx;
+            y1+=sy;
+        }
     }
 }
 
 void ssd1306_clear_square(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, uint32_t height) {
-    for(uint32_t i=0; i<width; ++i)
-        for(uint32_t j=0; j<height; ++j)
-            ssd1306_clear_pixel(p, x+i, y+j);
+    ssd1306_fill_rect(p, x, y, width, height, false);
 }
 
 void ssd1306_draw_square(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, uint32_t height) {
-    for(uint32_t i=0; i<width; ++i)
-        for(uint32_t j=0; j<height; ++j)
-            ssd1306_draw_pixel(p, x+i, y+j);
+    ssd1306_fill_rect(p, x, y, width, height, true);
 }
 
 void ssd1306_draw_empty_square(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, uint32_t height) {
-    ssd1306_draw_line(p, x, y, x+width, y);
-    ssd1306_draw_line(p, x, y+height, x+width, y+height);
-    ssd1306_draw_line(p, x, y, x, y+height);
-    ssd1306_draw_line(p, x+width, y, x+width, y+height);
+    ssd1306_draw_hline(p, x, y, width+1);
+    ssd1306_draw_hline(p, x, y+height, width+1);
+    ssd1306_draw_vline(p, x, y, height+1);
+    ssd1306_draw_vline(p, x+width, y, height+1);
+}
+
+/*
+ * bit expansion tables for scaled glyphs, indexed by a nibble of a font byte:
+ * every bit is repeated 2 (3) times, lsb stays on top
+ */
+static const uint8_t ssd1306_expand_x2[16]= {
+    0x00, 0x03, 0x0c, 0x0f, 0x30, 0x33, 0x3c, 0x3f, 0xc0, 0xc3, 0xcc, 0xcf, 0xf0, 0xf3, 0xfc, 0xff
+};
+
+static const uint16_t ssd1306_expand_x3[16]= {
+    0x000, 0x007, 0x038, 0x03f, 0x1c0, 0x1c7, 0x1f8, 0x1ff, 0xe00, 0xe07, 0xe38, 0xe3f, 0xfc0, 0xfc7, 0xff8, 0xfff
+};
+
+/*
+ * ors up to 24 vertical pixels (lsb on top) into column x starting at y.
+ * page aligned y touches one byte per 8 bits, any other y is shifted across
+ * the following page.
+ */
+static inline void ssd1306_or_column(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t bits) {
+    if(x>=p->width || !bits)
+        return;
+
+    uint32_t page=y>>3;
+    uint8_t *dst=p->buffer+x+p->width*page;
+
+    for(bits<<=(y&7); bits && page<p->pages; bits>>=8, ++page, dst+=p->width)
+        *dst|=(uint8_t) bits;
 }
 
 void ssd1306_draw_char_with_font(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t scale, const uint8_t *font, char c) {
@@ -198,17 +382,48 @@ void ssd1306_draw_char_with_font(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t
         return;
 
     uint32_t parts_per_line=(font[0]>>3)+((font[0]&7)>0);
-    for(uint8_t w=0; w<font[1]; ++w) { // width
-        uint32_t pp=(c-font[3])*font[1]*parts_per_line+w*parts_per_line+5;
+    const uint8_t *glyph=font+5+(c-font[3])*font[1]*parts_per_line;
+
+    if(scale==1) {
+        if(!(y&7) && parts_per_line==1 && x+font[1]<=p->width && y<p->height) {
+            // font column maps directly onto one buffer byte
+            uint8_t *dst=p->buffer+x+p->width*(y>>3);
+            for(uint8_t w=0; w<font[1]; ++w)
+                dst[w]|=glyph[w];
+            return;
+        }
+
+        for(uint8_t w=0; w<font[1]; ++w, glyph+=parts_per_line)
+            for(uint32_t lp=0; lp<parts_per_line; ++lp)
+                ssd1306_or_column(p, x+w, y+(lp<<3), glyph[lp]);
+        return;
+    }
+
+    if(scale==2 || scale==3) {
+        for(uint8_t w=0; w<font[1]; ++w, glyph+=parts_per_line) {
+            for(uint32_t lp=0; lp<parts_per_line; ++lp) {
+                uint8_t line=glyph[lp];
+                uint32_t bits;
+                if(scale==2)
+                    bits=ssd1306_expand_x2[line&0x0f]|(ssd1306_expand_x2[line>>4]<<8);
+                else
+                    bits=ssd1306_expand_x3[line&0x0f]|(ssd1306_expand_x3[line>>4]<<12);
+
+                for(uint32_t sx=0; sx<scale; ++sx)
+                    ssd1306_or_column(p, x+w*scale+sx, y+lp*8*scale, bits);
+            }
+        }
+        return;
+    }
+
+    for(uint8_t w=0; w<font[1]; ++w, glyph+=parts_per_line) {
         for(uint32_t lp=0; lp<parts_per_line; ++lp) {
-            uint8_t line=font[pp];
+            uint8_t line=glyph[lp];
 
             for(int8_t j=0; j<8; ++j, line>>=1) {
                 if(line & 1)
                     ssd1306_draw_square(p, x+w*scale, y+((lp<<3)+j)*scale, scale, scale);
             }
-
-            ++pp;
         }
     }
 }
@@ -290,17 +505,130 @@ inline void ssd1306_bmp_show_image(ssd1306_t *p, const uint8_t *data, const long
     ssd1306_bmp_show_image_with_offset(p, data, size, 0, 0);
 }
 
-void ssd1306_show(ssd1306_t *p) {
-    uint8_t payload[]= {SET_COL_ADDR, 0, p->width-1, SET_PAGE_ADDR, 0, p->pages-1};
-    if(p->width==64) {
-        payload[1]+=32;
-        payload[2]+=32;
+/*
+ * writes the pixels selected by mask in column x, 8 rows starting at y,
+ * either or'ed into the buffer or replacing the pixels below them.
+ * unaligned y is shifted across two pages.
+ */
+static inline void ssd1306_put_column(ssd1306_t *p, uint32_t x, uint32_t y, uint8_t bits, uint8_t mask, bool replace) {
+    if(x>=p->width)
+        return;
+
+    uint32_t page=y>>3;
+    uint16_t b=(uint16_t) ((bits&mask)<<(y&7));
+    uint16_t m=replace?(uint16_t) (mask<<(y&7)):0;
+    uint8_t *dst=p->buffer+x+p->width*page;
+
+    if(page<p->pages)
+        *dst=(*dst&~(uint8_t) m)|(uint8_t) b;
+    if(((m|b)>>8) && page+1<p->pages)
+        dst[p->width]=(dst[p->width]&~(uint8_t) (m>>8))|(uint8_t) (b>>8);
+}
+
+/*
+ * single blitter for raw page format images, shared by ssd1306_draw_image
+ * and ssd1306_blit. page aligned images fully on screen that replace the
+ * pixels below them are copied with memcpy.
+ */
+static void ssd1306_put_image(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, uint32_t height, const uint8_t *data, bool replace) {
+    const uint32_t pages=(height>>3)+((height&7)>0);
+    const uint8_t last_mask=(height&7)?(uint8_t) (0xff>>(8-(height&7))):0xff;
+
+    if(replace && !(y&7) && !(height&7) && x+width<=p->width && y+height<=p->height) {
+        uint8_t *dst=p->buffer+x+p->width*(y>>3);
+        for(uint32_t pg=0; pg<pages; ++pg, dst+=p->width, data+=width)
+            memcpy(dst, data, width);
+        return;
+    }
+
+    for(uint32_t pg=0; pg<pages; ++pg, data+=width) {
+        uint8_t mask=pg==pages-1?last_mask:0xff;
+        for(uint32_t w=0; w<width; ++w)
+            ssd1306_put_column(p, x+w, y+(pg<<3), data[w], mask, replace);
     }
+}
+
+void ssd1306_draw_image(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, uint32_t height, const uint8_t *data) {
+    ssd1306_put_image(p, x, y, width, height, data, false);
+}
+
+void ssd1306_blit(ssd1306_t *p, uint32_t x, uint32_t y, const uint8_t *img) {
+    const uint32_t width=img[0];
+    const uint32_t height=img[1];
+    const uint32_t pages=(height>>3)+((height&7)>0);
+    const uint8_t last_mask=(height&7)?(uint8_t) (0xff>>(8-(height&7))):0xff;
+    const uint8_t *data=img+3;
 
-    for(size_t i=0; i<sizeof(payload); ++i)
-        ssd1306_write(p, payload[i]);
+    if(!width || !height)
+        return;
+
+    if(img[2]==SSD1306_IMAGE_RAW) {
+        ssd1306_put_image(p, x, y, width, height, data, true);
+        return;
+    }
 
-    *(p->buffer-1)=0x40;
+    if(img[2]!=SSD1306_IMAGE_RLE)
+        return;
+
+    // packets: 0x80|(n-1) followed by one byte repeated n times, or (n-1) followed by n literal bytes
+    uint32_t col=0, pg=0;
+    while(pg<pages) {
+        uint8_t ctl=*(data++);
+        uint32_t n=(ctl&0x7f)+1;
+        bool run=ctl&0x80;
+
+        for(; n && pg<pages; --n) {
+            uint8_t v=run?*data:*(data++);
+            ssd1306_put_column(p, x+col, y+(pg<<3), v, pg==pages-1?last_mask:0xff, true);
+            if(++col==width) {
+                col=0;
+                ++pg;
+            }
+        }
+
+        if(run)
+            ++data;
+    }
+}
 
-    fancy_write(p->i2c_i, p->address, p->buffer-1, p->bufsize+1, "ssd1306_show");
+void ssd1306_show(ssd1306_t *p) {
+    uint8_t *hdr=p->buffer-SSD1306_ADDR_HEADER_SIZE;
+    ssd1306_window_header(p, hdr, 0, p->width-1, 0, p->pages-1);
+
+    fancy_write(p, hdr, p->bufsize+SSD1306_ADDR_HEADER_SIZE, "ssd1306_show");
+}
+
+void ssd1306_show_region(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, uint32_t height) {
+    if(x>=p->width || y>=p->height || !width || !height)
+        return;
+
+    if(width>p->width-x)
+        width=p->width-x;
+    if(height>p->height-y)
+        height=p->height-y;
+
+    uint32_t page_start=y>>3;
+    uint32_t page_end=(y+height-1)>>3;
+
+    if(width==p->width) {
+        // pages are contiguous in the buffer, borrow the bytes in front of them for the header
+        uint8_t *hdr=p->buffer+page_start*p->width-SSD1306_ADDR_HEADER_SIZE;
+        uint8_t saved[SSD1306_ADDR_HEADER_SIZE];
+
+        memcpy(saved, hdr, SSD1306_ADDR_HEADER_SIZE);
+        ssd1306_window_header(p, hdr, 0, p->width-1, page_start, page_end);
+        fancy_write(p, hdr, (page_end-page_start+1)*p->width+SSD1306_ADDR_HEADER_SIZE, "ssd1306_show_region");
+        memcpy(hdr, saved, SSD1306_ADDR_HEADER_SIZE);
+        return;
+    }
+
+    uint8_t payload[SSD1306_ADDR_HEADER_SIZE+256];
+    if(width>sizeof(payload)-SSD1306_ADDR_HEADER_SIZE)
+        width=sizeof(payload)-SSD1306_ADDR_HEADER_SIZE;
+
+    for(uint32_t page=page_start; page<=page_end; ++page) {
+        ssd1306_window_header(p, payload, x, x+width-1, page, page);
+        memcpy(payload+SSD1306_ADDR_HEADER_SIZE, p->buffer+x+page*p->width, width);
+        fancy_write(p, payload, width+SSD1306_ADDR_HEADER_SIZE, "ssd1306_show_region");
+    }
 }
@@ -53,9 +53,75 @@ typedef enum {
     SET_DISP_CLK_DIV = 0xD5,
     SET_PRECHARGE = 0xD9,
     SET_VCOM_DESEL = 0xDB,
-    SET_CHARGE_PUMP = 0x8D
+    SET_CHARGE_PUMP = 0x8D,
+    SET_SCROLL_RIGHT = 0x26,
+    SET_SCROLL_LEFT = 0x27,
+    SET_SCROLL_VERT_RIGHT = 0x29,
+    SET_SCROLL_VERT_LEFT = 0x2A,
+    SET_SCROLL_OFF = 0x2E,
+    SET_SCROLL_ON = 0x2F,
+    SET_VERT_SCROLL_AREA = 0xA3,
+    SET_FADE_BLINK = 0x23
 } ssd1306_command_t;
 
+/**
+*	@brief horizontal direction of hardware scrolling
+*/
+typedef enum {
+    SSD1306_SCROLL_RIGHT = 0,
+    SSD1306_SCROLL_LEFT = 1
+} ssd1306_scroll_dir_t;
+
+/**
+*	@brief frames between two scroll steps, values as encoded by the controller
+*/
+typedef enum {
+    SSD1306_SCROLL_2_FRAMES = 7,
+    SSD1306_SCROLL_3_FRAMES = 4,
+    SSD1306_SCROLL_4_FRAMES = 5,
+    SSD1306_SCROLL_5_FRAMES = 0,
+    SSD1306_SCROLL_25_FRAMES = 6,
+    SSD1306_SCROLL_64_FRAMES = 1,
+    SSD1306_SCROLL_128_FRAMES = 2,
+    SSD1306_SCROLL_256_FRAMES = 3
+} ssd1306_scroll_speed_t;
+
+/**
+*	@brief fade and blink modes (only available on SSD1306B controllers)
+*/
+typedef enum {
+    SSD1306_FADE_OFF = 0x00,
+    SSD1306_FADE_OUT = 0x20,
+    SSD1306_FADE_BLINK = 0x30
+} ssd1306_fade_mode_t;
+
+/**
+*	@brief storage formats of images drawn by ssd1306_blit
+*/
+typedef enum {
+    SSD1306_IMAGE_RAW = 0,
+    SSD1306_IMAGE_RLE = 1
+} ssd1306_image_format_t;
+
+/**
+*	@brief maximum number of commands in a ssd1306_cmd_list_t
+*/
+#define SSD1306_CMD_LIST_MAX 32
+
+/**
+*	@brief bytes reserved in front of the display buffer for the addressing commands of ssd1306_show
+*
+*	six commands, each preceded by a continuation control byte (0x80), followed by the data control byte (0x40)
+*/
+#define SSD1306_ADDR_HEADER_SIZE 13
+
+/**
+*	@brief sends one complete i2c write transaction to the display
+
+*	@return number of bytes written or a negative PICO_ERROR_ code
+*/
+typedef int (*ssd1306_write_fn)(void *ctx, const uint8_t *src, size_t len);
+
 /**
 *	@brief holds the configuration
 */
@@ -68,8 +134,18 @@ typedef struct {
     bool external_vcc; 	/**< whether display uses external vcc */ 
     uint8_t *buffer;	/**< display buffer */
     size_t bufsize;		/**< buffer size */
+    ssd1306_write_fn write_fn;	/**< replaces i2c_write_blocking if set, see ssd1306_set_write_fn */
+    void *write_ctx;	/**< passed to write_fn */
 } ssd1306_t;
 
+/**
+*	@brief list of commands sent in a single i2c transaction after one control byte
+*/
+typedef struct {
+    uint8_t buf[SSD1306_CMD_LIST_MAX+1];	/**< control byte followed by the commands */
+    size_t len;							/**< number of commands in list */
+} ssd1306_cmd_list_t;
+
 /**
 *	@brief initialize display
 *
@@ -85,6 +161,17 @@ typedef struct {
 */
 bool ssd1306_init(ssd1306_t *p, uint16_t width, uint16_t height, uint8_t address, i2c_inst_t *i2c_instance);
 
+/**
+	@brief route all transfers through fn instead of i2c_write_blocking
+
+	lets the display share a bus with a transaction scheduler
+
+	@param[in] p : instance of display
+	@param[in] fn : write function, NULL restores i2c_write_blocking
+	@param[in] ctx : passed to fn
+*/
+void ssd1306_set_write_fn(ssd1306_t *p, ssd1306_write_fn fn, void *ctx);
+
 /**
 *	@brief deinitialize display
 *
@@ -127,6 +214,106 @@ void ssd1306_contrast(ssd1306_t *p, uint8_t val);
 */
 void ssd1306_invert(ssd1306_t *p, uint8_t inv);
 
+/**
+	@brief start continuous horizontal scrolling of a range of pages
+
+	the controller moves the pixels itself, no data has to be sent while
+	scrolling. writing to the display while scrolling corrupts the
+	scrolled area, stop scrolling first.
+
+	@param[in] p : instance of display
+	@param[in] dir : direction of scrolling
+	@param[in] start_page : first page to scroll
+	@param[in] end_page : last page to scroll
+	@param[in] speed : frames between two scroll steps
+*/
+void ssd1306_scroll_horizontal(ssd1306_t *p, ssd1306_scroll_dir_t dir, uint8_t start_page, uint8_t end_page, ssd1306_scroll_speed_t speed);
+
+/**
+	@brief start continuous diagonal scrolling
+
+	pages start_page to end_page move horizontally, the whole display
+	moves vertically by vertical_offset rows every step
+
+	@param[in] p : instance of display
+	@param[in] dir : horizontal direction of scrolling
+	@param[in] start_page : first page to scroll horizontally
+	@param[in] end_page : last page to scroll horizontally
+	@param[in] speed : frames between two scroll steps
+	@param[in] vertical_offset : rows moved up every step (1 to height-1)
+*/
+void ssd1306_scroll_diagonal(ssd1306_t *p, ssd1306_scroll_dir_t dir, uint8_t start_page, uint8_t end_page, ssd1306_scroll_speed_t speed, uint8_t vertical_offset);
+
+/**
+	@brief stop scrolling
+
+	the displayed image is undefined afterwards, the buffer should be sent again
+
+	@param[in] p : instance of display
+*/
+void ssd1306_scroll_stop(ssd1306_t *p);
+
+/**
+	@brief start fading out or blinking (SSD1306B only, ignored by other controllers)
+
+	@param[in] p : instance of display
+	@param[in] mode : fade mode, SSD1306_FADE_OFF restores normal output
+	@param[in] interval : 0-15, a step takes 8*(interval+1) frames
+*/
+void ssd1306_fade(ssd1306_t *p, ssd1306_fade_mode_t mode, uint8_t interval);
+
+/**
+	@brief reset command list
+
+	@param[in] l : command list
+*/
+void ssd1306_cmd_list_init(ssd1306_cmd_list_t *l);
+
+/**
+	@brief append command byte to command list
+
+	@param[in] l : command list
+	@param[in] cmd : command or command argument
+
+	@return bool.
+	@retval true for Success
+	@retval false if list is full
+*/
+bool ssd1306_cmd_list_add(ssd1306_cmd_list_t *l, uint8_t cmd);
+
+/**
+	@brief send all commands of list in one transaction and reset it
+
+	@param[in] p : instance of display
+	@param[in] l : command list
+*/
+void ssd1306_cmd_list_send(ssd1306_t *p, ssd1306_cmd_list_t *l);
+
+/**
+	@brief send array of commands, packed into as few transactions as possible
+
+	@param[in] p : instance of display
+	@param[in] cmds : commands and their arguments
+	@param[in] len : number of bytes in cmds
+*/
+void ssd1306_write_cmds(ssd1306_t *p, const uint8_t *cmds, size_t len);
+
+/**
+	@brief write addressing commands for a window into SSD1306_ADDR_HEADER_SIZE bytes
+
+	the header selects the column and page window and ends with the data
+	control byte, so buffer data sent right after it in the same
+	transaction lands in that window
+
+	@param[in] p : instance of display
+	@param[out] hdr : destination of header
+	@param[in] col_start : first column
+	@param[in] col_end : last column
+	@param[in] page_start : first page
+	@param[in] page_end : last page
+*/
+void ssd1306_window_header(ssd1306_t *p, uint8_t *hdr, uint8_t col_start, uint8_t col_end, uint8_t page_start, uint8_t page_end);
+
 /**
 	@brief display buffer, should be called on change
 
@@ -135,6 +322,17 @@ void ssd1306_invert(ssd1306_t *p, uint8_t inv);
 */
 void ssd1306_show(ssd1306_t *p);
 
+/**
+	@brief send only the pages and columns covering the given region of the buffer
+
+	@param[in] p : instance of display
+	@param[in] x : x position of region
+	@param[in] y : y position of region (rounded down to its page)
+	@param[in] width : width of region
+	@param[in] height : height of region (rounded up to full pages)
+*/
+void ssd1306_show_region(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, uint32_t height);
+
 /**
 	@brief clear display buffer
 
@@ -161,6 +359,26 @@ void ssd1306_clear_pixel(ssd1306_t *p, uint32_t x, uint32_t y);
 */
 void ssd1306_draw_pixel(ssd1306_t *p, uint32_t x, uint32_t y);
 
+/**
+	@brief draw horizontal line on buffer
+
+	@param[in] p : instance of display
+	@param[in] x : x position of starting point
+	@param[in] y : y position of line
+	@param[in] width : length of line in pixels
+*/
+void ssd1306_draw_hline(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width);
+
+/**
+	@brief draw vertical line on buffer
+
+	@param[in] p : instance of display
+	@param[in] x : x position of line
+	@param[in] y : y position of starting point
+	@param[in] height : length of line in pixels
+*/
+void ssd1306_draw_vline(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t height);
+
 /**
 	@brief draw line on buffer
 
@@ -225,9 +443,43 @@ void ssd1306_bmp_show_image_with_offset(ssd1306_t *p, const uint8_t *data, const
 */
 void ssd1306_bmp_show_image(ssd1306_t *p, const uint8_t *data, const long size);
 
+/**
+	@brief draw image stored in display page format
+
+	every byte holds 8 vertical pixels (lsb on top), bytes run left to right
+	and pages top to bottom, so a page of the image is width bytes
+	set pixels are or'ed into the buffer, see ssd1306_blit to replace them
+
+	@param[in] p : instance of display
+	@param[in] x : x position of image
+	@param[in] y : y position of image
+	@param[in] width : width of image
+	@param[in] height : height of image
+	@param[in] data : image data
+*/
+void ssd1306_draw_image(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, uint32_t height, const uint8_t *data);
+
+/**
+	@brief copy image in display page format into buffer, replacing the pixels below it
+
+	image layout: <width>, <height>, <ssd1306_image_format_t>, <data>.
+	data is laid out as for ssd1306_draw_image, optionally run length encoded.
+	generate images with tools/bin2c -i [-r].
+	page aligned raw images fully on screen are copied with memcpy.
+
+	@param[in] p : instance of display
+	@param[in] x : x position of image
+	@param[in] y : y position of image
+	@param[in] img : image
+*/
+void ssd1306_blit(ssd1306_t *p, uint32_t x, uint32_t y, const uint8_t *img);
+
 /**
 	@brief draw char with given font
 
+	font columns are or'ed directly into the buffer for scale 1 to 3,
+	larger scales fall back to drawing squares
+
 	@param[in] p : instance of display
 	@param[in] x : x starting position of char
 	@param[in] y : y starting position of char
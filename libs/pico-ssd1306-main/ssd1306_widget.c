@@ -0,0 +1,192 @@
+#include <pico/stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "ssd1306.h"
+#include "ssd1306_widget.h"
+
+// cell of the builtin font_8x5: 5 columns plus 1 column spacing, 8 rows
+#define CHAR_WIDTH 6
+#define CHAR_HEIGHT 8
+
+static void ssd1306_widget_init(ssd1306_widget_t *w, ssd1306_widget_type_t type, uint32_t x, uint32_t y) {
+    memset(w, 0, sizeof(*w));
+    w->type=type;
+    w->x=x;
+    w->y=y;
+    w->dirty=true;
+    w->invalid=true;
+}
+
+static void ssd1306_widget_format(ssd1306_widget_t *w) {
+    char buf[SSD1306_WIDGET_TEXT_MAX];
+    snprintf(buf, sizeof(buf), "%s%ld", w->prefix, (long) w->value);
+    ssd1306_widget_set_text(w, buf);
+}
+
+void ssd1306_widget_label(ssd1306_widget_t *w, uint32_t x, uint32_t y, uint32_t scale, const char *text) {
+    ssd1306_widget_init(w, SSD1306_WIDGET_LABEL, x, y);
+    w->scale=scale;
+    w->height=CHAR_HEIGHT*scale;
+    ssd1306_widget_set_text(w, text);
+}
+
+void ssd1306_widget_counter(ssd1306_widget_t *w, uint32_t x, uint32_t y, uint32_t scale, const char *prefix, int32_t value) {
+    ssd1306_widget_init(w, SSD1306_WIDGET_COUNTER, x, y);
+    w->scale=scale;
+    w->height=CHAR_HEIGHT*scale;
+    w->prefix=prefix;
+    w->value=value;
+    ssd1306_widget_format(w);
+}
+
+void ssd1306_widget_progress(ssd1306_widget_t *w, uint32_t x, uint32_t y, uint32_t width, uint32_t height, int32_t max) {
+    ssd1306_widget_init(w, SSD1306_WIDGET_PROGRESS, x, y);
+    w->width=width;
+    w->height=height;
+    w->max=max>0?max:1;
+}
+
+void ssd1306_widget_icon(ssd1306_widget_t *w, uint32_t x, uint32_t y, uint32_t width, uint32_t height, const uint8_t *data) {
+    ssd1306_widget_init(w, SSD1306_WIDGET_ICON, x, y);
+    w->width=width;
+    w->height=height;
+    w->data=data;
+}
+
+void ssd1306_widget_set_text(ssd1306_widget_t *w, const char *text) {
+    if(!strncmp(w->text, text, SSD1306_WIDGET_TEXT_MAX-1))
+        return;
+
+    // strncpy pads with zeros, so text and shown can be compared byte by byte
+    strncpy(w->text, text, SSD1306_WIDGET_TEXT_MAX-1);
+
+    uint32_t width=strlen(w->text)*CHAR_WIDTH*w->scale;
+    if(width>w->width)
+        w->width=width;
+
+    w->dirty=true;
+}
+
+void ssd1306_widget_set_value(ssd1306_widget_t *w, int32_t value) {
+    if(w->value==value)
+        return;
+
+    w->value=value;
+    if(w->type==SSD1306_WIDGET_COUNTER)
+        ssd1306_widget_format(w);
+    else
+        w->dirty=true;
+}
+
+static void ssd1306_widget_draw_text(ssd1306_t *p, ssd1306_widget_t *w, ssd1306_flush_fn flush) {
+    uint32_t first=SSD1306_WIDGET_TEXT_MAX, last=0;
+
+    for(uint32_t i=0; i<SSD1306_WIDGET_TEXT_MAX; ++i) {
+        if(w->text[i]!=w->shown[i]) {
+            if(first>i)
+                first=i;
+            last=i;
+        }
+    }
+
+    if(first==SSD1306_WIDGET_TEXT_MAX)
+        return;
+
+    uint32_t cell=CHAR_WIDTH*w->scale;
+    uint32_t x=w->x+first*cell;
+    uint32_t width=(last-first+1)*cell;
+
+    ssd1306_clear_square(p, x, w->y, width, w->height);
+    for(uint32_t i=first; i<=last && w->text[i]; ++i)
+        ssd1306_draw_char(p, w->x+i*cell, w->y, w->scale, w->text[i]);
+
+    memcpy(w->shown, w->text, SSD1306_WIDGET_TEXT_MAX);
+
+    if(flush)
+        flush(p, x, w->y, width, w->height);
+}
+
+static void ssd1306_widget_draw_progress(ssd1306_t *p, ssd1306_widget_t *w, ssd1306_flush_fn flush) {
+    if(w->width<3 || w->height<3)
+        return;
+
+    uint32_t inner=w->width-2;
+    int32_t value=w->value<0?0:(w->value>w->max?w->max:w->value);
+    uint32_t fill=inner*(uint32_t) value/(uint32_t) w->max;
+
+    if(w->invalid) {
+        ssd1306_clear_square(p, w->x, w->y, w->width, w->height);
+        ssd1306_draw_empty_square(p, w->x, w->y, w->width-1, w->height-1);
+        ssd1306_draw_square(p, w->x+1, w->y+1, fill, w->height-2);
+        w->shown_fill=fill;
+        if(flush)
+            flush(p, w->x, w->y, w->width, w->height);
+        return;
+    }
+
+    if(fill==w->shown_fill)
+        return;
+
+    uint32_t from=fill<w->shown_fill?fill:w->shown_fill;
+    uint32_t span=fill<w->shown_fill?w->shown_fill-fill:fill-w->shown_fill;
+
+    if(fill>w->shown_fill)
+        ssd1306_draw_square(p, w->x+1+from, w->y+1, span, w->height-2);
+    else
+        ssd1306_clear_square(p, w->x+1+from, w->y+1, span, w->height-2);
+    w->shown_fill=fill;
+
+    if(flush)
+        flush(p, w->x+1+from, w->y+1, span, w->height-2);
+}
+
+static void ssd1306_widget_draw(ssd1306_t *p, ssd1306_widget_t *w, ssd1306_flush_fn flush) {
+    switch(w->type) {
+    case SSD1306_WIDGET_LABEL:
+    case SSD1306_WIDGET_COUNTER:
+        if(w->invalid) {
+            ssd1306_clear_square(p, w->x, w->y, w->width, w->height);
+            memset(w->shown, 0, SSD1306_WIDGET_TEXT_MAX);
+        }
+        ssd1306_widget_draw_text(p, w, flush);
+        break;
+    case SSD1306_WIDGET_PROGRESS:
+        ssd1306_widget_draw_progress(p, w, flush);
+        break;
+    case SSD1306_WIDGET_ICON:
+        ssd1306_clear_square(p, w->x, w->y, w->width, w->height);
+        ssd1306_draw_image(p, w->x, w->y, w->width, w->height, w->data);
+        if(flush)
+            flush(p, w->x, w->y, w->width, w->height);
+        break;
+    }
+
+    w->dirty=false;
+    w->invalid=false;
+}
+
+void ssd1306_screen_init(ssd1306_screen_t *s, ssd1306_t *p, ssd1306_widget_t *widgets, size_t count) {
+    s->disp=p;
+    s->widgets=widgets;
+    s->count=count;
+    s->flush=ssd1306_show_region;
+}
+
+void ssd1306_screen_show(ssd1306_screen_t *s) {
+    ssd1306_clear(s->disp);
+
+    for(size_t i=0; i<s->count; ++i) {
+        s->widgets[i].invalid=true;
+        ssd1306_widget_draw(s->disp, &s->widgets[i], NULL);
+    }
+
+    s->flush(s->disp, 0, 0, s->disp->width, s->disp->height);
+}
+
+void ssd1306_screen_update(ssd1306_screen_t *s) {
+    for(size_t i=0; i<s->count; ++i) {
+        if(s->widgets[i].dirty || s->widgets[i].invalid)
+            ssd1306_widget_draw(s->disp, &s->widgets[i], s->flush);
+    }
+}
@@ -0,0 +1,155 @@
+/**
+* @file ssd1306_widget.h
+*
+* retained-mode widgets for ssd1306 displays
+*
+* widgets remember what they last put into the display buffer. after a
+* change only the affected part is redrawn and only the pages it covers
+* are sent to the display.
+*/
+
+#ifndef _inc_ssd1306_widget
+#define _inc_ssd1306_widget
+#include <pico/stdlib.h>
+
+#include "ssd1306.h"
+
+/**
+*	@brief maximum text length of label and counter widgets (including terminator)
+*/
+#define SSD1306_WIDGET_TEXT_MAX 24
+
+/**
+*	@brief kinds of widgets
+*/
+typedef enum {
+    SSD1306_WIDGET_LABEL,
+    SSD1306_WIDGET_COUNTER,
+    SSD1306_WIDGET_PROGRESS,
+    SSD1306_WIDGET_ICON
+} ssd1306_widget_type_t;
+
+/**
+*	@brief holds a widget and what it last drew
+*/
+typedef struct {
+    ssd1306_widget_type_t type;		/**< kind of widget */
+    uint32_t x;						/**< x position of bounding box */
+    uint32_t y;						/**< y position of bounding box */
+    uint32_t width;					/**< width of bounding box */
+    uint32_t height;				/**< height of bounding box */
+    uint32_t scale;					/**< font scale of label and counter */
+    bool dirty;						/**< widget changed since last draw */
+    bool invalid;					/**< whole bounding box has to be drawn */
+    char text[SSD1306_WIDGET_TEXT_MAX];		/**< text to show, zero padded */
+    char shown[SSD1306_WIDGET_TEXT_MAX];	/**< text currently in buffer, zero padded */
+    const char *prefix;				/**< counter text in front of value */
+    int32_t value;					/**< counter or progress value */
+    int32_t max;					/**< progress value of a full bar */
+    uint32_t shown_fill;			/**< progress bar pixels currently filled in buffer */
+    const uint8_t *data;			/**< icon in page format, see ssd1306_draw_image */
+} ssd1306_widget_t;
+
+/**
+*	@brief sends a changed region of the buffer to the display
+*/
+typedef void (*ssd1306_flush_fn)(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, uint32_t height);
+
+/**
+*	@brief group of widgets making up one screen
+*/
+typedef struct {
+    ssd1306_t *disp;				/**< display to draw to */
+    ssd1306_widget_t *widgets;		/**< widgets of screen */
+    size_t count;					/**< number of widgets */
+    ssd1306_flush_fn flush;			/**< called for every changed region, ssd1306_show_region after init */
+} ssd1306_screen_t;
+
+/**
+	@brief initialize label widget with builtin font
+
+	@param[in] w : widget
+	@param[in] x : x position of text
+	@param[in] y : y position of text
+	@param[in] scale : font scale
+	@param[in] text : text to show
+*/
+void ssd1306_widget_label(ssd1306_widget_t *w, uint32_t x, uint32_t y, uint32_t scale, const char *text);
+
+/**
+	@brief initialize counter widget showing prefix followed by a number
+
+	@param[in] w : widget
+	@param[in] x : x position of text
+	@param[in] y : y position of text
+	@param[in] scale : font scale
+	@param[in] prefix : text in front of value, must stay valid
+	@param[in] value : initial value
+*/
+void ssd1306_widget_counter(ssd1306_widget_t *w, uint32_t x, uint32_t y, uint32_t scale, const char *prefix, int32_t value);
+
+/**
+	@brief initialize progress bar widget with 1px border
+
+	@param[in] w : widget
+	@param[in] x : x position of bar
+	@param[in] y : y position of bar
+	@param[in] width : width of bar
+	@param[in] height : height of bar
+	@param[in] max : value of a full bar
+*/
+void ssd1306_widget_progress(ssd1306_widget_t *w, uint32_t x, uint32_t y, uint32_t width, uint32_t height, int32_t max);
+
+/**
+	@brief initialize icon widget
+
+	@param[in] w : widget
+	@param[in] x : x position of icon
+	@param[in] y : y position of icon
+	@param[in] width : width of icon
+	@param[in] height : height of icon
+	@param[in] data : icon in page format, must stay valid
+*/
+void ssd1306_widget_icon(ssd1306_widget_t *w, uint32_t x, uint32_t y, uint32_t width, uint32_t height, const uint8_t *data);
+
+/**
+	@brief change text of label widget
+
+	@param[in] w : widget
+	@param[in] text : new text
+*/
+void ssd1306_widget_set_text(ssd1306_widget_t *w, const char *text);
+
+/**
+	@brief change value of counter or progress widget
+
+	@param[in] w : widget
+	@param[in] value : new value
+*/
+void ssd1306_widget_set_value(ssd1306_widget_t *w, int32_t value);
+
+/**
+	@brief initialize screen
+
+	@param[in] s : screen
+	@param[in] p : instance of display
+	@param[in] widgets : widgets of screen, must stay valid
+	@param[in] count : number of widgets
+*/
+void ssd1306_screen_init(ssd1306_screen_t *s, ssd1306_t *p, ssd1306_widget_t *widgets, size_t count);
+
+/**
+	@brief clear display buffer, draw all widgets and flush the whole buffer
+
+	@param[in] s : screen
+*/
+void ssd1306_screen_show(ssd1306_screen_t *s);
+
+/**
+	@brief redraw changed parts of dirty widgets and flush only their regions
+
+	@param[in] s : screen
+*/
+void ssd1306_screen_update(ssd1306_screen_t *s);
+
+#endif
@@ -48,31 +48,213 @@ void convert_to_char_array(const char *name, FILE *in, FILE *out) {
     fprintf(out, "\n};\n");
 }
 
+uint32_t get_val(const uint8_t *data, size_t offset, uint8_t size) {
+    uint32_t val=0;
+    for(uint8_t i=0; i<size; ++i)
+        val|=(uint32_t) data[offset+i]<<(8*i);
+    return val;
+}
+
+/*
+ * converts a monochrome bmp into the vertical byte page layout of the
+ * ssd1306 (lsb on top, width bytes per page), see ssd1306_blit
+ */
+uint8_t *bmp_to_pages(const uint8_t *data, size_t size, uint32_t *width, uint32_t *height) {
+    if(size<54||data[0]!='B'||data[1]!='M') {
+        fprintf(stderr, "Input is not a bmp file!\n");
+        return NULL;
+    }
+
+    const uint32_t bfOffBits=get_val(data, 10, 4);
+    const uint32_t biSize=get_val(data, 14, 4);
+    const uint32_t biWidth=get_val(data, 18, 4);
+    const int32_t biHeight=(int32_t) get_val(data, 22, 4);
+    const uint32_t abs_height=biHeight>0?biHeight:-biHeight;
+
+    if(get_val(data, 28, 2)!=1||get_val(data, 30, 4)!=0) {
+        fprintf(stderr, "Only uncompressed monochrome bmp files are supported!\n");
+        return NULL;
+    }
+
+    if(biWidth==0||biWidth>255||abs_height==0||abs_height>255) {
+        fprintf(stderr, "Image size %ux%u not supported!\n", biWidth, abs_height);
+        return NULL;
+    }
+
+    uint32_t bytes_per_line=((biWidth+31)/32)*4;
+    if(bfOffBits+bytes_per_line*abs_height>size||14+biSize+8>size) {
+        fprintf(stderr, "Truncated bmp file!\n");
+        return NULL;
+    }
+
+    // pixels using the black palette entry are set (lit), as in ssd1306_bmp_show_image
+    const uint8_t *table=data+14+biSize;
+    uint8_t color_val=0;
+    for(uint8_t i=0; i<2; ++i) {
+        if(!(table[i*4]|table[i*4+1]|table[i*4+2])) {
+            color_val=i;
+            break;
+        }
+    }
+
+    uint32_t pages=(abs_height+7)/8;
+    uint8_t *out=calloc(pages*biWidth, 1);
+    if(out==NULL)
+        return NULL;
+
+    for(uint32_t y=0; y<abs_height; ++y) {
+        // bottom-up rows unless height is negative
+        const uint8_t *row=data+bfOffBits+bytes_per_line*(biHeight>0?biHeight-1-y:y);
+        for(uint32_t x=0; x<biWidth; ++x) {
+            if(((row[x>>3]>>(7-(x&7)))&1)==color_val)
+                out[(y>>3)*biWidth+x]|=1<<(y&7);
+        }
+    }
+
+    *width=biWidth;
+    *height=abs_height;
+    return out;
+}
+
+/*
+ * packbits style encoding: 0x80|(n-1) followed by a byte repeated n times,
+ * or (n-1) followed by n literal bytes
+ */
+size_t rle_encode(const uint8_t *in, size_t len, uint8_t *out) {
+    size_t o=0;
+
+    for(size_t i=0; i<len;) {
+        size_t run=1;
+        while(i+run<len&&run<128&&in[i+run]==in[i])
+            ++run;
+
+        if(run>=3) {
+            out[o++]=0x80|(run-1);
+            out[o++]=in[i];
+            i+=run;
+            continue;
+        }
+
+        size_t lit=0;
+        while(i+lit<len&&lit<128) {
+            if(i+lit+2<len&&in[i+lit]==in[i+lit+1]&&in[i+lit]==in[i+lit+2])
+                break;
+            ++lit;
+        }
+
+        out[o++]=lit-1;
+        memcpy(out+o, in+i, lit);
+        o+=lit;
+        i+=lit;
+    }
+
+    return o;
+}
+
+int convert_to_image(const char *name, FILE *in, FILE *out, int rle) {
+    fseek(in, 0, SEEK_END);
+    size_t file_size=ftell(in);
+    fseek(in, 0, SEEK_SET);
+
+    uint8_t *data=malloc(file_size);
+    if(data==NULL||fread(data, 1, file_size, in)!=file_size) {
+        free(data);
+        fprintf(stderr, "Could not read input file!\n");
+        return -1;
+    }
+
+    uint32_t width, height;
+    uint8_t *pages=bmp_to_pages(data, file_size, &width, &height);
+    free(data);
+    if(pages==NULL)
+        return -1;
+
+    size_t len=width*((height+7)/8);
+    uint8_t *body=pages;
+
+    if(rle) {
+        // worst case adds one control byte per 128 literals
+        uint8_t *enc=malloc(len+len/128+1);
+        if(enc==NULL) {
+            free(pages);
+            return -1;
+        }
+        size_t enc_len=rle_encode(pages, len, enc);
+        if(enc_len<len) {
+            body=enc;
+            len=enc_len;
+        } else {
+            free(enc);
+            rle=0;
+        }
+    }
+
+    fprintf(out, "const unsigned char %s_image[]={\n", name);
+    fprintf(out, "%u, %u, %d, // width, height, %s\n", width, height, rle, rle?"SSD1306_IMAGE_RLE":"SSD1306_IMAGE_RAW");
+
+    for(size_t i=0; i<len; ++i) {
+        fprintf(out, i+1<len?"0x%02x,":"0x%02x", body[i]);
+        if(((i+1)&15)==0)
+            fprintf(out, "\n");
+    }
+    fprintf(out, "\n};\n");
+
+    if(body!=pages)
+        free(body);
+    free(pages);
+    return 0;
+}
+
+void usage(const char *prog) {
+    fprintf(stderr, "Usage: %s [-i [-r]] [input file] [output file?]\n", prog);
+    fprintf(stderr, "  -i: convert monochrome bmp into ssd1306 page format image\n");
+    fprintf(stderr, "  -r: run length encode image\n");
+}
+
 int main(int ac, char *as[]) {
-    if(ac<2||ac>3) {
-        fprintf(stderr, "Usage: %s [input file] [output file?]\n", as[0]);
+    int image=0, rle=0, arg=1;
+
+    for(; arg<ac&&as[arg][0]=='-'; ++arg) {
+        if(!strcmp(as[arg], "-i"))
+            image=1;
+        else if(!strcmp(as[arg], "-r"))
+            rle=1;
+        else {
+            usage(as[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if(ac-arg<1||ac-arg>2||(rle&&!image)) {
+        usage(as[0]);
         return EXIT_FAILURE;
     }
 
     FILE *in=NULL, *out=NULL;
 
-    if((in=fopen(as[1], "rb"))==NULL) {
-        fprintf(stderr, "Could not open \"%s\" for reading!\n", as[1]);
+    if((in=fopen(as[arg], "rb"))==NULL) {
+        fprintf(stderr, "Could not open \"%s\" for reading!\n", as[arg]);
         goto fail;
     }
 
-    if(ac==3) {
-        if((out=fopen(as[2], "w"))==NULL) {
-            fprintf(stderr, "Could not open \"%s\" for writing!\n", as[2]);
+    if(ac-arg==2) {
+        if((out=fopen(as[arg+1], "w"))==NULL) {
+            fprintf(stderr, "Could not open \"%s\" for writing!\n", as[arg+1]);
             goto fail;
         }
     } else
         out=stdout;
 
-    char *norm_name=strdup(as[1]);
+    char *norm_name=strdup(as[arg]);
     normalize_name(norm_name);
 
-    convert_to_char_array(norm_name, in, out);
+    if(image) {
+        if(convert_to_image(norm_name, in, out, rle)) {
+            free(norm_name);
+            goto fail;
+        }
+    } else
+        convert_to_char_array(norm_name, in, out);
 
     free(norm_name);
 
@@ -0,0 +1,443 @@
+#include "live_server.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "pico/stdlib.h"       // to_ms_since_boot()
+#include "pico/cyw43_arch.h"   // cyw43_arch_lwip_begin()/end()
+#include "lwip/tcp.h"          // API "raw" de TCP do lwIP
+#include "lwip/timeouts.h"     // sys_timeout() para o heartbeat dos fluxos
+#include "net_stats.h"         // Uso de memória do lwIP para a rota /net
+
+// Etapas de uma conexão
+typedef enum {
+    LIVE_CONN_FREE = 0,
+    LIVE_CONN_REQUEST,            // Lendo o cabeçalho da requisição
+    LIVE_CONN_STREAM              // Fluxo de eventos aberto
+} live_conn_state_t;
+
+typedef struct {
+    struct tcp_pcb *pcb;
+    live_conn_state_t state;
+    char request[LIVE_SERVER_REQUEST_SIZE];
+    size_t request_len;
+    uint8_t header_end;           // Bytes de "\r\n\r\n" já reconhecidos
+    uint32_t opened_ms;
+} live_conn_t;
+
+// Estado da partida visto pelos espectadores
+typedef struct {
+    bool playing;
+    uint32_t games;               // Partidas iniciadas
+    uint16_t round;
+    uint8_t leds;
+    uint8_t red;                  // Pressionamentos na rodada atual
+    uint8_t blue;
+    uint32_t rounds;              // Rodadas concluídas
+    uint32_t hits;                // Rodadas acertadas
+    uint16_t best;                // Maior rodada acertada
+    bool has_last;
+    live_event_t last;            // Último resultado
+} live_game_t;
+
+// ----- Estado do servidor (acessado com o lock do lwIP) -----
+static struct tcp_pcb *listener;
+static live_conn_t conns[LIVE_SERVER_MAX_CLIENTS];
+static struct tcp_pcb *callback_pcb;      // PCB cujo callback do lwIP está em andamento
+static struct tcp_pcb *aborted;           // PCB abortada dentro do próprio callback (deve retornar ERR_ABRT)
+static bool heartbeat_armed;
+static live_game_t game;
+static uint32_t events_sent;
+static uint32_t events_dropped;
+static char out[LIVE_SERVER_EVENT_SIZE];  // Evento ou resposta em montagem
+
+// Painel servido em "/": só HTML e o EventSource do navegador, sem dependências
+static const char dashboard_html[] =
+    "<!DOCTYPE html><html><head><meta charset=\"utf-8\">"
+    "<meta name=\"viewport\" content=\"width=device-width\"><title>LedReflex ao vivo</title>"
+    "<style>body{font-family:sans-serif;margin:2em}b{font-size:2em}</style></head><body>"
+    "<h1>LedReflex ao vivo</h1>"
+    "<p>Rodada <b id=\"round\">-</b> LEDs <b id=\"leds\">-</b></p>"
+    "<p>Vermelho <b id=\"red\">0</b> Azul <b id=\"blue\">0</b></p>"
+    "<p id=\"msg\">Aguardando partida...</p>"
+    "<p>Partidas <span id=\"games\">0</span> | Rodadas <span id=\"rounds\">0</span> | "
+    "Acertos <span id=\"hits\">0</span> | Recorde <span id=\"best\">0</span></p>"
+    "<script>"
+    "var s=new EventSource('/events');"
+    "function $(i){return document.getElementById(i)}"
+    "function set(o){for(var k in o)if($(k))$(k).textContent=o[k]}"
+    "function on(n,f){s.addEventListener(n,function(e){f(JSON.parse(e.data))})}"
+    "on('state',set);"
+    "on('game_start',function(d){$('msg').textContent='Partida '+d.game+' iniciada'});"
+    "on('round_start',function(d){set({round:d.round,leds:d.leds,red:0,blue:0});"
+    "$('msg').textContent='Memorize o padrao!'});"
+    "on('press',function(d){set({red:d.red,blue:d.blue});$('msg').textContent='Contando...'});"
+    "on('result',function(d){$('msg').textContent=(d.success?'Acertou! ':'Errou! ')+"
+    "'Esperado: '+d.expected_red+' vermelho, '+d.expected_blue+' azul'});"
+    "</script></body></html>";
+
+static const char heartbeat[] = ": ping\n\n";
+
+static void live_server_heartbeat(void *arg);
+
+// Desliga os callbacks e fecha a conexão. Se a PCB for abortada durante um callback
+// dela mesma, fica registrada em "aborted" para que esse callback retorne ERR_ABRT.
+// Fora de um callback da PCB (heartbeat, publicação) nada é registrado: o lwIP
+// reaproveita o endereço da PCB liberada na próxima conexão aceita.
+static void live_server_close(live_conn_t *conn, bool abort) {
+    if (conn->pcb) {
+        tcp_arg(conn->pcb, NULL);
+        tcp_recv(conn->pcb, NULL);
+        tcp_sent(conn->pcb, NULL);
+        tcp_poll(conn->pcb, NULL, 0);
+        tcp_err(conn->pcb, NULL);
+        if (abort || tcp_close(conn->pcb) != ERR_OK) {
+            if (conn->pcb == callback_pcb) {
+                aborted = conn->pcb;
+            }
+            tcp_abort(conn->pcb);
+        }
+        conn->pcb = NULL;
+    }
+    conn->state = LIVE_CONN_FREE;
+}
+
+// Valor de retorno de um callback da PCB "tpcb"; encerra o callback em andamento
+static inline err_t live_server_cb_result(struct tcp_pcb *tpcb) {
+    callback_pcb = NULL;
+    if (aborted == tpcb) {
+        aborted = NULL;
+        return ERR_ABRT;
+    }
+    return ERR_OK;
+}
+
+// Entrega "len" bytes ao TCP de uma vez; ERR_MEM se não couberem agora no buffer de envio
+static err_t live_server_write(live_conn_t *conn, const void *data, size_t len, u8_t flags) {
+    if (tcp_sndbuf(conn->pcb) < len) {
+        return ERR_MEM;
+    }
+    return tcp_write(conn->pcb, data, (u16_t)len, flags);
+}
+
+static int live_server_format_result(char *buf, size_t size, const live_event_t *ev) {
+    return snprintf(buf, size,
+                    "{\"round\":%u,\"expected_red\":%u,\"user_red\":%u,\"expected_blue\":%u,"
+                    "\"user_blue\":%u,\"success\":%s,\"game_over\":%s,\"t\":%u}",
+                    ev->round, ev->expected_red, ev->user_red, ev->expected_blue, ev->user_blue,
+                    ev->success ? "true" : "false", ev->success ? "false" : "true", (unsigned)ev->time_ms);
+}
+
+// Estado completo em JSON (resposta de /state e evento "state")
+static int live_server_format_state(char *buf, size_t size) {
+    uint32_t clients = 0;
+    for (int i = 0; i < LIVE_SERVER_MAX_CLIENTS; i++) {
+        clients += conns[i].state == LIVE_CONN_STREAM;
+    }
+    int n = snprintf(buf, size,
+                     "{\"playing\":%s,\"round\":%u,\"leds\":%u,\"red\":%u,\"blue\":%u,"
+                     "\"games\":%u,\"rounds\":%u,\"hits\":%u,\"best\":%u,"
+                     "\"clients\":%u,\"events\":%u,\"dropped\":%u,\"uptime_ms\":%u,\"last\":",
+                     game.playing ? "true" : "false", game.round, game.leds, game.red, game.blue,
+                     (unsigned)game.games, (unsigned)game.rounds, (unsigned)game.hits, game.best,
+                     (unsigned)clients, (unsigned)events_sent, (unsigned)events_dropped,
+                     (unsigned)to_ms_since_boot(get_absolute_time()));
+    if (n < 0 || (size_t)n >= size) {
+        return -1;
+    }
+    int m = game.has_last ? live_server_format_result(buf + n, size - n, &game.last)
+                          : snprintf(buf + n, size - n, "null");
+    if (m < 0 || (size_t)(n + m) >= size - 1) {
+        return -1;
+    }
+    buf[n + m] = '}';
+    buf[n + m + 1] = '\0';
+    return n + m + 1;
+}
+
+// Evento "state" no formato SSE
+static int live_server_format_state_event(char *buf, size_t size) {
+    int n = snprintf(buf, size, "event: state\ndata: ");
+    int m = live_server_format_state(buf + n, size - n - 2);
+    if (m < 0) {
+        return -1;
+    }
+    memcpy(buf + n + m, "\n\n", 3);
+    return n + m + 2;
+}
+
+// Resposta completa seguida do fechamento da conexão (o lwIP envia o FIN após os dados)
+static void live_server_respond(live_conn_t *conn, const char *status, const char *content_type,
+                                const char *body, size_t body_len, bool body_static) {
+    char header[192];
+    int n = snprintf(header, sizeof(header),
+                     "HTTP/1.1 %s\r\nContent-Type: %s\r\nContent-Length: %u\r\n"
+                     "Cache-Control: no-store\r\nAccess-Control-Allow-Origin: *\r\n"
+                     "Connection: close\r\n\r\n",
+                     status, content_type, (unsigned)body_len);
+    bool ok = live_server_write(conn, header, (size_t)n, TCP_WRITE_FLAG_COPY | TCP_WRITE_FLAG_MORE) == ERR_OK &&
+              live_server_write(conn, body, body_len, body_static ? 0 : TCP_WRITE_FLAG_COPY) == ERR_OK &&
+              tcp_output(conn->pcb) == ERR_OK;
+    live_server_close(conn, !ok);
+}
+
+// Abre o fluxo de eventos: cabeçalho sem Content-Length e o estado atual como primeiro evento
+static void live_server_open_stream(live_conn_t *conn) {
+    static const char header[] =
+        "HTTP/1.1 200 OK\r\nContent-Type: text/event-stream\r\nCache-Control: no-cache\r\n"
+        "Access-Control-Allow-Origin: *\r\nConnection: keep-alive\r\n\r\n"
+        "retry: 2000\n\n";
+    conn->state = LIVE_CONN_STREAM;
+    tcp_nagle_disable(conn->pcb);  // Eventos pequenos saem na hora, sem esperar ACK do anterior
+    int n = live_server_format_state_event(out, sizeof(out));
+    if (n < 0 || live_server_write(conn, header, sizeof(header) - 1, 0) != ERR_OK ||
+        live_server_write(conn, out, (size_t)n, TCP_WRITE_FLAG_COPY) != ERR_OK ||
+        tcp_output(conn->pcb) != ERR_OK) {
+        live_server_close(conn, true);
+        return;
+    }
+    printf("DEBUG: Espectador conectado ao fluxo de eventos\n");
+    if (!heartbeat_armed) {
+        heartbeat_armed = true;
+        sys_timeout(LIVE_SERVER_HEARTBEAT_MS, live_server_heartbeat, NULL);
+    }
+}
+
+// Cabeçalho completo: atende a rota pedida na linha de requisição
+static void live_server_handle(live_conn_t *conn) {
+    char *path = strchr(conn->request, ' ');
+    if (!path) {
+        live_server_respond(conn, "400 Bad Request", "text/plain", "Bad Request\n", 12, true);
+        return;
+    }
+    bool get = path - conn->request == 3 && strncmp(conn->request, "GET", 3) == 0;
+    path++;
+    size_t len = strcspn(path, " ?\r\n");
+
+    if (!get) {
+        live_server_respond(conn, "405 Method Not Allowed", "text/plain", "Method Not Allowed\n", 19, true);
+    } else if (len == 1 && path[0] == '/') {
+        live_server_respond(conn, "200 OK", "text/html; charset=utf-8",
+                            dashboard_html, sizeof(dashboard_html) - 1, true);
+    } else if (len == 6 && strncmp(path, "/state", 6) == 0) {
+        int n = live_server_format_state(out, sizeof(out));
+        if (n < 0) {
+            live_server_close(conn, true);
+            return;
+        }
+        live_server_respond(conn, "200 OK", "application/json", out, (size_t)n, false);
+    } else if (len == 4 && strncmp(path, "/net", 4) == 0) {
+        int n = net_stats_format_json(out, sizeof(out));
+        if (n < 0) {
+            live_server_close(conn, true);
+            return;
+        }
+        live_server_respond(conn, "200 OK", "application/json", out, (size_t)n, false);
+    } else if (len == 7 && strncmp(path, "/events", 7) == 0) {
+        live_server_open_stream(conn);
+    } else {
+        live_server_respond(conn, "404 Not Found", "text/plain", "Not Found\n", 10, true);
+    }
+}
+
+// Envia um evento já formatado a todos os fluxos; quem não tem espaço no buffer perde o evento
+static void live_server_broadcast(const char *data, size_t len) {
+    events_sent++;
+    for (int i = 0; i < LIVE_SERVER_MAX_CLIENTS; i++) {
+        live_conn_t *conn = &conns[i];
+        if (conn->state != LIVE_CONN_STREAM) {
+            continue;
+        }
+        if (live_server_write(conn, data, len, TCP_WRITE_FLAG_COPY) != ERR_OK) {
+            events_dropped++;
+            continue;
+        }
+        tcp_output(conn->pcb);
+    }
+}
+
+// Comentário periódico nos fluxos: um cliente que nem isso consegue receber é desconectado
+static void live_server_heartbeat(void *arg) {
+    heartbeat_armed = false;
+    for (int i = 0; i < LIVE_SERVER_MAX_CLIENTS; i++) {
+        live_conn_t *conn = &conns[i];
+        if (conn->state != LIVE_CONN_STREAM) {
+            continue;
+        }
+        if (live_server_write(conn, heartbeat, sizeof(heartbeat) - 1, 0) != ERR_OK) {
+            printf("DEBUG: Espectador sem resposta; fluxo encerrado\n");
+            live_server_close(conn, true);
+            continue;
+        }
+        tcp_output(conn->pcb);
+        heartbeat_armed = true;
+    }
+    if (heartbeat_armed) {
+        sys_timeout(LIVE_SERVER_HEARTBEAT_MS, live_server_heartbeat, NULL);
+    }
+}
+
+// Erro fatal na conexão: o lwIP já liberou a PCB
+static void live_server_err(void *arg, err_t err) {
+    live_conn_t *conn = (live_conn_t *)arg;
+    conn->pcb = NULL;
+    conn->state = LIVE_CONN_FREE;
+}
+
+static err_t live_server_recv(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t err) {
+    static const char header_end[] = "\r\n\r\n";
+    live_conn_t *conn = (live_conn_t *)arg;
+    callback_pcb = tpcb;
+    if (!p) {
+        live_server_close(conn, false);  // Cliente fechou (ex.: aba do painel fechada)
+        return live_server_cb_result(tpcb);
+    }
+    tcp_recved(tpcb, p->tot_len);
+    if (conn->state == LIVE_CONN_REQUEST) {
+        for (struct pbuf *q = p; q && conn->header_end < 4; q = q->next) {
+            const char *data = (const char *)q->payload;
+            for (u16_t i = 0; i < q->len && conn->header_end < 4; i++) {
+                char ch = data[i];
+                if (conn->request_len < sizeof(conn->request) - 1) {
+                    conn->request[conn->request_len++] = ch;
+                    conn->request[conn->request_len] = '\0';
+                }
+                conn->header_end = ch == header_end[conn->header_end] ? conn->header_end + 1 : (ch == '\r' ? 1 : 0);
+            }
+        }
+        if (conn->header_end == 4) {
+            live_server_handle(conn);
+        }
+    }
+    // Dados depois do cabeçalho (ou enviados pelo espectador no fluxo) são descartados
+    pbuf_free(p);
+    return live_server_cb_result(tpcb);
+}
+
+// Chamado a cada segundo: encerra quem abriu a conexão e não enviou a requisição
+static err_t live_server_poll(void *arg, struct tcp_pcb *tpcb) {
+    live_conn_t *conn = (live_conn_t *)arg;
+    callback_pcb = tpcb;
+    if (conn->state == LIVE_CONN_REQUEST &&
+        to_ms_since_boot(get_absolute_time()) - conn->opened_ms > LIVE_SERVER_REQUEST_TIMEOUT_MS) {
+        live_server_close(conn, true);
+    }
+    return live_server_cb_result(tpcb);
+}
+
+static err_t live_server_accept(void *arg, struct tcp_pcb *newpcb, err_t err) {
+    if (err != ERR_OK || !newpcb) {
+        return ERR_VAL;
+    }
+    live_conn_t *conn = NULL;
+    for (int i = 0; i < LIVE_SERVER_MAX_CLIENTS && !conn; i++) {
+        if (conns[i].state == LIVE_CONN_FREE) {
+            conn = &conns[i];
+        }
+    }
+    if (!conn) {
+        printf("DEBUG: Servidor ao vivo cheio; conexao recusada\n");
+        tcp_abort(newpcb);
+        return ERR_ABRT;
+    }
+    conn->pcb = newpcb;
+    conn->state = LIVE_CONN_REQUEST;
+    conn->request_len = 0;
+    conn->request[0] = '\0';
+    conn->header_end = 0;
+    conn->opened_ms = to_ms_since_boot(get_absolute_time());
+    tcp_arg(newpcb, conn);
+    tcp_recv(newpcb, live_server_recv);
+    tcp_err(newpcb, live_server_err);
+    tcp_poll(newpcb, live_server_poll, 2);
+    return ERR_OK;
+}
+
+bool live_server_init(uint16_t port) {
+    bool ok = false;
+    cyw43_arch_lwip_begin();
+    if (!listener) {
+        struct tcp_pcb *pcb = tcp_new_ip_type(IPADDR_TYPE_ANY);
+        if (pcb && tcp_bind(pcb, IP_ADDR_ANY, port) == ERR_OK) {
+            listener = tcp_listen(pcb);  // Libera "pcb" e retorna a PCB de escuta
+            if (listener) {
+                tcp_accept(listener, live_server_accept);
+                ok = true;
+            }
+        } else if (pcb) {
+            tcp_close(pcb);
+        }
+    }
+    cyw43_arch_lwip_end();
+    if (ok) {
+        printf("DEBUG: Servidor ao vivo na porta %u\n", port);
+    } else {
+        printf("DEBUG: Falha ao iniciar o servidor ao vivo\n");
+    }
+    return ok;
+}
+
+void live_server_publish(const live_event_t *ev) {
+    if (!listener) {
+        return;
+    }
+    cyw43_arch_lwip_begin();
+    int n = -1;
+    switch (ev->type) {
+    case LIVE_EVENT_GAME_START:
+        game.playing = true;
+        game.games++;
+        game.round = 0;
+        game.leds = 0;
+        game.red = game.blue = 0;
+        n = snprintf(out, sizeof(out), "event: game_start\ndata: {\"game\":%u,\"t\":%u}\n\n",
+                     (unsigned)game.games, (unsigned)ev->time_ms);
+        break;
+    case LIVE_EVENT_ROUND_START:
+        game.round = ev->round;
+        game.leds = ev->leds;
+        game.red = game.blue = 0;
+        n = snprintf(out, sizeof(out),
+                     "event: round_start\ndata: {\"round\":%u,\"leds\":%u,\"expected_red\":%u,"
+                     "\"expected_blue\":%u,\"t\":%u}\n\n",
+                     ev->round, ev->leds, ev->expected_red, ev->expected_blue, (unsigned)ev->time_ms);
+        break;
+    case LIVE_EVENT_PRESS:
+        game.red = ev->user_red;
+        game.blue = ev->user_blue;
+        n = snprintf(out, sizeof(out), "event: press\ndata: {\"round\":%u,\"red\":%u,\"blue\":%u,\"t\":%u}\n\n",
+                     ev->round, ev->user_red, ev->user_blue, (unsigned)ev->time_ms);
+        break;
+    case LIVE_EVENT_RESULT: {
+        game.rounds++;
+        if (ev->success) {
+            game.hits++;
+            if (ev->round > game.best) {
+                game.best = ev->round;
+            }
+        } else {
+            game.playing = false;
+        }
+        game.last = *ev;
+        game.has_last = true;
+        n = snprintf(out, sizeof(out), "event: result\ndata: ");
+        n += live_server_format_result(out + n, sizeof(out) - n - 2, ev);
+        memcpy(out + n, "\n\n", 3);
+        n += 2;
+        break;
+    }
+    default:
+        break;
+    }
+    if (n > 0 && (size_t)n < sizeof(out)) {
+        live_server_broadcast(out, (size_t)n);
+        // Depois de um resultado as estatísticas mudam: os painéis recebem o estado completo
+        if (ev->type == LIVE_EVENT_RESULT) {
+            n = live_server_format_state_event(out, sizeof(out));
+            if (n > 0) {
+                live_server_broadcast(out, (size_t)n);
+            }
+        }
+    }
+    cyw43_arch_lwip_end();
+}
@@ -0,0 +1,68 @@
+#ifndef LIVE_SERVER_H
+#define LIVE_SERVER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ----- Rotas (HTTP/1.1, apenas GET) -----
+//
+//   /         painel HTML que acompanha a partida pelo /events
+//   /state    estado atual e estatísticas em JSON
+//   /net      uso de memória do lwIP em JSON (net_stats)
+//   /events   fluxo Server-Sent Events (text/event-stream) com os eventos abaixo
+//
+// Eventos do fluxo ("event:" seguido de uma linha "data:" com JSON):
+//   state        estado completo, enviado ao conectar
+//   game_start   {"game","t"}
+//   round_start  {"round","leds","expected_red","expected_blue","t"}
+//   press        {"round","red","blue","t"} com as contagens acumuladas da rodada
+//   result       {"round","expected_red","user_red","expected_blue","user_blue","success","game_over","t"}
+// "t" é o instante do evento em ms desde o boot.
+
+// Conexões atendidas ao mesmo tempo (fluxos e requisições avulsas)
+#define LIVE_SERVER_MAX_CLIENTS 4
+
+// Linha de requisição guardada para análise (o restante do cabeçalho é descartado)
+#define LIVE_SERVER_REQUEST_SIZE 128
+
+// Maior evento ou resposta JSON montados de uma vez
+#define LIVE_SERVER_EVENT_SIZE 768
+
+// Prazo para o cliente enviar o cabeçalho da requisição
+#define LIVE_SERVER_REQUEST_TIMEOUT_MS 5000
+
+// Comentário enviado aos fluxos ociosos para detectar clientes que sumiram
+#define LIVE_SERVER_HEARTBEAT_MS 15000
+
+// Tipos de evento
+typedef enum {
+    LIVE_EVENT_GAME_START = 0,
+    LIVE_EVENT_ROUND_START,
+    LIVE_EVENT_PRESS,
+    LIVE_EVENT_RESULT
+} live_event_type_t;
+
+// Evento do jogo (16 bytes: cabe em um pedido de net_core_submit())
+typedef struct {
+    uint8_t type;               // live_event_type_t
+    uint8_t leds;               // LEDs acesos na rodada
+    uint16_t round;
+    uint8_t expected_red;
+    uint8_t expected_blue;
+    uint8_t user_red;           // Pressionamentos até agora (PRESS) ou finais (RESULT)
+    uint8_t user_blue;
+    bool success;
+    uint32_t time_ms;           // Instante do evento, registrado por quem o gerou
+} live_event_t;
+
+// Abre o servidor na "port" em todas as interfaces. Requer o lwIP iniciado;
+// o servidor passa a responder assim que o Wi‑Fi tiver endereço.
+bool live_server_init(uint16_t port);
+
+// Atualiza o estado do jogo e envia o evento na hora a todos os fluxos abertos.
+// Um cliente lento demais perde o evento (as contagens acumuladas do próximo o
+// corrigem). Sem servidor iniciado não faz nada.
+// Pode ser chamada fora do contexto do lwIP (usa cyw43_arch_lwip_begin/end).
+void live_server_publish(const live_event_t *event);
+
+#endif // LIVE_SERVER_H
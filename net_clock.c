@@ -0,0 +1,202 @@
+#include "net_clock.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "pico/stdlib.h"       // time_us_64()
+#include "pico/sync.h"         // critical_section_t: o relógio é lido pelo outro núcleo
+#include "pico/cyw43_arch.h"   // cyw43_arch_lwip_begin()/end()
+#include "lwip/udp.h"
+#include "lwip/timeouts.h"     // sys_timeout() para as consultas periódicas
+#include "lwip/dns.h"          // Resolução do nome do servidor
+#include "wifi_link.h"         // Consultas só com o enlace ativo
+
+// Pacote SNTP (RFC 4330): 48 bytes, carimbos de tempo em big-endian
+#define SNTP_PACKET_SIZE 48
+#define SNTP_MODE_CLIENT 3
+#define SNTP_MODE_SERVER 4
+#define SNTP_VERSION 4
+#define SNTP_ORIGINATE 24
+#define SNTP_RECEIVE 32
+#define SNTP_TRANSMIT 40
+
+// Segundos entre 1900-01-01 (época do NTP) e 1970-01-01
+#define NTP_UNIX_OFFSET 2208988800u
+
+// ----- Estado do cliente (acessado com o lock do lwIP) -----
+static struct udp_pcb *pcb;
+static const char *server_host;
+static ip_addr_t server_addr;
+static bool resolved;
+static bool resolving;
+static uint64_t request_us;             // time_us_64() do envio da consulta em andamento (0 = nenhuma)
+
+// ----- Mapeamento time_us_64() -> UTC (protegido por clock_lock) -----
+static critical_section_t clock_lock;
+static volatile bool synced;
+static uint64_t base_mono_us;           // Instante local da última sincronização
+static uint64_t base_unix_us;           // Hora do servidor nesse instante
+static int32_t drift_ppb;               // Correção de frequência do cristal
+
+static void net_clock_timer(void *arg);
+
+static uint32_t get_be32(const uint8_t *p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+// Carimbo NTP (segundos e fração de 2^-32 s) em µs desde 1970. Segundos abaixo
+// da época Unix indicam a era 1 do NTP (a partir de 2036).
+static uint64_t ntp_to_unix_us(const uint8_t *p) {
+    uint64_t seconds = get_be32(p);
+    uint64_t fraction = get_be32(p + 4);
+    if (seconds < NTP_UNIX_OFFSET) {
+        seconds += 0x100000000ull;
+    }
+    return (seconds - NTP_UNIX_OFFSET) * 1000000u + ((fraction * 1000000u) >> 32);
+}
+
+// Extrapola a partir da última sincronização, com a deriva estimada (chamar com clock_lock)
+static uint64_t net_clock_map(uint64_t mono_us) {
+    int64_t elapsed = (int64_t)(mono_us - base_mono_us);
+    return base_unix_us + elapsed + elapsed * drift_ppb / 1000000000;
+}
+
+// Nova amostra: a hora do servidor "unix_us" corresponde ao instante local "mono_us"
+static void net_clock_apply(uint64_t mono_us, uint64_t unix_us, uint32_t rtt_us) {
+    critical_section_enter_blocking(&clock_lock);
+    int64_t error = 0;
+    if (synced) {
+        // Erro acumulado desde a última sincronização: vira correção de frequência
+        error = (int64_t)(unix_us - net_clock_map(mono_us));
+        uint64_t span = mono_us - base_mono_us;
+        if (span >= NET_CLOCK_MIN_DRIFT_SPAN_US && error > -1000000 && error < 1000000) {
+            int64_t ppb = drift_ppb + error * 1000000000 / (int64_t)span / 2;  // Metade: amortece o ruído da rede
+            drift_ppb = (int32_t)(ppb > NET_CLOCK_MAX_DRIFT_PPB ? NET_CLOCK_MAX_DRIFT_PPB :
+                                  ppb < -NET_CLOCK_MAX_DRIFT_PPB ? -NET_CLOCK_MAX_DRIFT_PPB : ppb);
+        }
+    }
+    base_mono_us = mono_us;
+    base_unix_us = unix_us;
+    synced = true;
+    int32_t drift = drift_ppb;
+    critical_section_exit(&clock_lock);
+    printf("DEBUG: Relogio sincronizado: ajuste %lld us, ida e volta %u us, deriva %ld ppb\n",
+           (long long)error, (unsigned)rtt_us, (long)drift);
+}
+
+// Resposta do servidor (contexto do lwIP)
+static void net_clock_recv(void *arg, struct udp_pcb *upcb, struct pbuf *p, const ip_addr_t *addr, u16_t port) {
+    uint64_t now_us = time_us_64();
+    uint8_t msg[SNTP_PACKET_SIZE];
+    bool ok = pbuf_copy_partial(p, msg, sizeof(msg), 0) == sizeof(msg);
+    pbuf_free(p);
+
+    // Só a resposta da consulta em andamento: o servidor devolve nosso carimbo de envio
+    uint8_t li = msg[0] >> 6;
+    uint8_t mode = msg[0] & 0x07;
+    uint8_t stratum = msg[1];
+    if (!ok || !request_us || memcmp(msg + SNTP_ORIGINATE, &request_us, sizeof(request_us)) != 0 ||
+        mode != SNTP_MODE_SERVER || li == 3 || stratum == 0 || stratum > 15) {
+        return;
+    }
+    uint64_t t1 = request_us;
+    request_us = 0;
+
+    // Ida e volta descontado o tempo de processamento no servidor
+    uint64_t server_rx = ntp_to_unix_us(msg + SNTP_RECEIVE);
+    uint64_t server_tx = ntp_to_unix_us(msg + SNTP_TRANSMIT);
+    int64_t rtt = (int64_t)(now_us - t1) - (int64_t)(server_tx - server_rx);
+    if (rtt < 0) {
+        rtt = 0;
+    }
+    if (rtt > NET_CLOCK_MAX_RTT_US) {
+        printf("DEBUG: Amostra de hora descartada: ida e volta de %lld us\n", (long long)rtt);
+        return;  // A próxima tentativa já está agendada
+    }
+    net_clock_apply(now_us, server_tx + (uint64_t)rtt / 2, (uint32_t)rtt);
+    sys_untimeout(net_clock_timer, NULL);
+    sys_timeout(NET_CLOCK_POLL_MS, net_clock_timer, NULL);
+}
+
+static void net_clock_dns_found(const char *name, const ip_addr_t *ipaddr, void *arg) {
+    resolving = false;
+    if (!ipaddr) {
+        printf("DEBUG: Erro ao resolver %s\n", name);
+        return;  // Nova consulta na próxima tentativa
+    }
+    server_addr = *ipaddr;
+    resolved = true;
+}
+
+// Envia uma consulta; sem resposta válida, tenta de novo em NET_CLOCK_RETRY_MS
+static void net_clock_timer(void *arg) {
+    sys_timeout(NET_CLOCK_RETRY_MS, net_clock_timer, NULL);
+    if (wifi_link_state() != WIFI_LINK_UP) {
+        return;
+    }
+    if (!resolved) {
+        if (!resolving) {
+            err_t err = dns_gethostbyname(server_host, &server_addr, net_clock_dns_found, NULL);
+            if (err == ERR_OK) {
+                resolved = true;  // Endereço IP literal ou nome já no cache do lwIP
+            } else if (err == ERR_INPROGRESS) {
+                resolving = true;
+            }
+        }
+        if (!resolved) {
+            return;
+        }
+    }
+    struct pbuf *p = pbuf_alloc(PBUF_TRANSPORT, SNTP_PACKET_SIZE, PBUF_RAM);
+    if (!p) {
+        return;
+    }
+    uint8_t *msg = (uint8_t *)p->payload;
+    memset(msg, 0, SNTP_PACKET_SIZE);
+    msg[0] = (SNTP_VERSION << 3) | SNTP_MODE_CLIENT;
+    // O carimbo de envio vai opaco (instante local); o servidor o devolve como "originate"
+    request_us = time_us_64();
+    memcpy(msg + SNTP_TRANSMIT, &request_us, sizeof(request_us));
+    if (udp_sendto(pcb, p, &server_addr, NET_CLOCK_PORT) != ERR_OK) {
+        request_us = 0;
+        resolved = false;  // Refaz o DNS na próxima tentativa
+    }
+    pbuf_free(p);
+}
+
+bool net_clock_init(const char *host) {
+    bool ok = false;
+    cyw43_arch_lwip_begin();
+    if (!pcb) {
+        critical_section_init(&clock_lock);
+        server_host = host;
+        pcb = udp_new_ip_type(IPADDR_TYPE_ANY);
+        if (pcb && udp_bind(pcb, IP_ADDR_ANY, 0) == ERR_OK) {
+            udp_recv(pcb, net_clock_recv, NULL);
+            sys_timeout(NET_CLOCK_RETRY_MS, net_clock_timer, NULL);
+            ok = true;
+        } else if (pcb) {
+            udp_remove(pcb);
+            pcb = NULL;
+        }
+    }
+    cyw43_arch_lwip_end();
+    if (!ok) {
+        printf("DEBUG: Falha ao iniciar o cliente SNTP\n");
+    }
+    return ok;
+}
+
+bool net_clock_synced(void) {
+    return synced;
+}
+
+uint64_t net_clock_to_unix_us(uint64_t mono_us) {
+    if (!synced) {
+        return 0;
+    }
+    critical_section_enter_blocking(&clock_lock);
+    uint64_t unix_us = net_clock_map(mono_us);
+    critical_section_exit(&clock_lock);
+    return unix_us;
+}
@@ -0,0 +1,35 @@
+#ifndef NET_CLOCK_H
+#define NET_CLOCK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Porta do servidor NTP (server/NtpStandIn.py na rede local)
+#define NET_CLOCK_PORT 123
+
+// Intervalo entre sincronizações e entre tentativas até obter uma amostra válida
+#define NET_CLOCK_POLL_MS 64000
+#define NET_CLOCK_RETRY_MS 2000
+
+// Amostras com ida e volta maior que isto são descartadas (atraso assimétrico demais)
+#define NET_CLOCK_MAX_RTT_US 100000
+
+// A deriva só é reestimada com amostras separadas por pelo menos este tempo
+#define NET_CLOCK_MIN_DRIFT_SPAN_US 30000000
+
+// Limite da correção de deriva do cristal, em partes por bilhão
+#define NET_CLOCK_MAX_DRIFT_PPB 500000
+
+// Inicia o cliente SNTP para o servidor em "host" (nome ou endereço IP em texto).
+// A cada resposta o relógio é ajustado com a compensação do tempo de ida e volta,
+// e a deriva do cristal em relação ao servidor é estimada entre sincronizações.
+bool net_clock_init(const char *host);
+
+// Indica se já houve ao menos uma sincronização
+bool net_clock_synced(void);
+
+// Converte um instante de time_us_64() em µs desde 1970-01-01 UTC (0 se ainda
+// não sincronizado). Pode ser chamada de qualquer núcleo ou contexto.
+uint64_t net_clock_to_unix_us(uint64_t mono_us);
+
+#endif // NET_CLOCK_H
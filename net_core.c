@@ -0,0 +1,92 @@
+#include "net_core.h"
+
+#include <string.h>
+
+#include "pico/stdlib.h"
+#include "pico/multicore.h"     // Núcleo 1 e FIFO entre núcleos
+#include "pico/util/queue.h"    // Fila segura entre núcleos
+#include "pico/flash.h"         // flash_safe_execute_core_init()
+#include "pico/cyw43_arch.h"    // cyw43_arch_poll() e cyw43_arch_wait_for_work_until()
+#include "pico/async_context.h" // Worker que drena a fila no contexto do cyw43
+#include "hardware/sync.h"      // __sev()
+
+// Pedido do núcleo 0 para o núcleo 1
+typedef struct {
+    net_core_fn fn;
+    uint8_t data[NET_CORE_DATA_SIZE];
+} net_core_request_t;
+
+static queue_t requests;
+static bool (*core1_setup)(void);
+static volatile uint32_t dropped;
+
+// Executa os pedidos pendentes no núcleo 1
+static void net_core_drain(async_context_t *context, async_when_pending_worker_t *worker) {
+    net_core_request_t req;
+    while (queue_try_remove(&requests, &req)) {
+        req.fn(req.data);
+    }
+}
+
+// Com a rede ativa, a fila é drenada por um worker do contexto do cyw43:
+// net_core_submit() marca o worker como pendente, o que libera o semáforo em
+// que cyw43_arch_wait_for_work_until() espera e acorda o núcleo 1 na hora
+static async_when_pending_worker_t drain_worker = { .do_work = net_core_drain };
+static volatile bool worker_added;
+
+// Laço do núcleo 1: todo o trabalho de rede acontece aqui, fora das
+// interrupções do núcleo 0 (botões, temporização do jogo, display e sensor)
+static void net_core_main(void) {
+    bool network = core1_setup();
+    if (network) {
+        worker_added = async_context_add_when_pending_worker(cyw43_arch_async_context(), &drain_worker);
+        if (worker_added) {
+            async_context_set_work_pending(cyw43_arch_async_context(), &drain_worker);  // Pedidos já na fila
+        }
+    }
+    multicore_fifo_push_blocking(network);
+
+    while (true) {
+        if (network) {
+            if (!worker_added) {
+                net_core_drain(NULL, NULL);
+            }
+            cyw43_arch_poll();  // Driver, timers do lwIP e pedidos (drain_worker)
+            cyw43_arch_wait_for_work_until(make_timeout_time_ms(NET_CORE_POLL_MS));
+        } else {
+            net_core_drain(NULL, NULL);
+            __wfe();  // Sem rede: só acorda com pedidos (net_core_submit() faz __sev())
+        }
+    }
+}
+
+bool net_core_start(bool (*setup)(void)) {
+    queue_init(&requests, sizeof(net_core_request_t), NET_CORE_QUEUE_SIZE);
+    core1_setup = setup;
+    // O núcleo 1 grava na flash (log de resultados): o núcleo 0 precisa poder ser pausado
+    flash_safe_execute_core_init();
+    multicore_launch_core1(net_core_main);
+    return multicore_fifo_pop_blocking() != 0;
+}
+
+bool net_core_submit(net_core_fn fn, const void *data, size_t len) {
+    if (len > NET_CORE_DATA_SIZE) {
+        return false;
+    }
+    net_core_request_t req = { .fn = fn };
+    memcpy(req.data, data, len);
+    if (!queue_try_add(&requests, &req)) {
+        dropped++;
+        return false;
+    }
+    if (worker_added) {
+        async_context_set_work_pending(cyw43_arch_async_context(), &drain_worker);
+    } else {
+        __sev();  // Acorda o núcleo 1 se estiver esperando trabalho
+    }
+    return true;
+}
+
+uint32_t net_core_dropped(void) {
+    return dropped;
+}
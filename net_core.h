@@ -0,0 +1,35 @@
+#ifndef NET_CORE_H
+#define NET_CORE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Pedidos aguardando o núcleo 1
+#define NET_CORE_QUEUE_SIZE 16
+
+// Maior bloco de dados copiado junto com um pedido (um game_round_t)
+#define NET_CORE_DATA_SIZE 32
+
+// Espera máxima do núcleo 1 sem trabalho do driver; pedidos novos o acordam na
+// hora (net_core_submit() sinaliza o contexto do cyw43)
+#define NET_CORE_POLL_MS 5
+
+// Função executada no núcleo 1 com uma cópia dos dados do pedido
+typedef void (*net_core_fn)(const void *data);
+
+// Inicia o núcleo 1, que executa "setup" (ex.: iniciar o Wi-Fi e os clientes
+// de rede) e passa a atender o driver cyw43 e o lwIP em modo poll, além dos
+// pedidos do núcleo 0. Retorna o resultado de "setup". Os pedidos são
+// atendidos mesmo se "setup" falhar (ex.: gravação no log em flash).
+// Uso exclusivo em builds com NETWORK_ON_CORE1 (pico_cyw43_arch_lwip_poll).
+bool net_core_start(bool (*setup)(void));
+
+// Agenda "fn" no núcleo 1 com uma cópia de "len" bytes de "data" e retorna
+// imediatamente. Retorna false se a fila estiver cheia ou os dados não couberem.
+bool net_core_submit(net_core_fn fn, const void *data, size_t len);
+
+// Pedidos recusados por fila cheia
+uint32_t net_core_dropped(void);
+
+#endif // NET_CORE_H
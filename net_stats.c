@@ -0,0 +1,90 @@
+#include "net_stats.h"
+
+#include <stdio.h>
+
+#include "pico/cyw43_arch.h"   // cyw43_arch_lwip_begin()/end()
+#include "lwip/stats.h"        // lwip_stats (MEM_STATS e MEMP_STATS ativos em lwipopts.h)
+#include "lwip/memp.h"         // Índices dos pools
+
+static const char *const pool_names[NET_STATS_POOL_COUNT] = {
+    [NET_STATS_HEAP] = "heap",
+    [NET_STATS_PBUF_POOL] = "pbuf_pool",
+    [NET_STATS_PBUF_REF] = "pbuf_ref",
+    [NET_STATS_TCP_SEG] = "tcp_seg",
+    [NET_STATS_TCP_PCB] = "tcp_pcb",
+    [NET_STATS_TCP_PCB_LISTEN] = "tcp_pcb_listen",
+    [NET_STATS_UDP_PCB] = "udp_pcb",
+    [NET_STATS_SYS_TIMEOUT] = "sys_timeout",
+};
+
+// Pool do lwIP correspondente a cada entrada (o heap é tratado à parte)
+static const memp_t pool_memp[NET_STATS_POOL_COUNT] = {
+    [NET_STATS_PBUF_POOL] = MEMP_PBUF_POOL,
+    [NET_STATS_PBUF_REF] = MEMP_PBUF,
+    [NET_STATS_TCP_SEG] = MEMP_TCP_SEG,
+    [NET_STATS_TCP_PCB] = MEMP_TCP_PCB,
+    [NET_STATS_TCP_PCB_LISTEN] = MEMP_TCP_PCB_LISTEN,
+    [NET_STATS_UDP_PCB] = MEMP_UDP_PCB,
+    [NET_STATS_SYS_TIMEOUT] = MEMP_SYS_TIMEOUT,
+};
+
+static void net_stats_copy(net_stats_pool_t *out, const struct stats_mem *mem) {
+    out->used = mem->used;
+    out->max = mem->max;
+    out->avail = mem->avail;
+    out->err = mem->err;
+}
+
+const char *net_stats_pool_name(net_stats_pool_id_t id) {
+    return id < NET_STATS_POOL_COUNT ? pool_names[id] : "?";
+}
+
+void net_stats_get(net_stats_t *out) {
+    cyw43_arch_lwip_begin();
+    net_stats_copy(&out->pools[NET_STATS_HEAP], &lwip_stats.mem);
+    for (int i = NET_STATS_HEAP + 1; i < NET_STATS_POOL_COUNT; i++) {
+        net_stats_copy(&out->pools[i], lwip_stats.memp[pool_memp[i]]);
+    }
+    out->tcp_xmit = lwip_stats.tcp.xmit;
+    out->tcp_drop = lwip_stats.tcp.drop;
+    out->tcp_memerr = lwip_stats.tcp.memerr;
+    cyw43_arch_lwip_end();
+}
+
+int net_stats_format_json(char *buf, size_t size) {
+    net_stats_t s;
+    net_stats_get(&s);
+    size_t n = 0;
+    int w = snprintf(buf, size, "{\"profile\":\"%s\"", LWIP_PROFILE_NAME);
+    for (int i = 0; w >= 0 && i < NET_STATS_POOL_COUNT; i++) {
+        n += (size_t)w;
+        if (n >= size) {
+            return -1;
+        }
+        const net_stats_pool_t *p = &s.pools[i];
+        w = snprintf(buf + n, size - n, ",\"%s\":{\"used\":%u,\"max\":%u,\"avail\":%u,\"err\":%u}",
+                     pool_names[i], (unsigned)p->used, (unsigned)p->max, (unsigned)p->avail, (unsigned)p->err);
+    }
+    if (w < 0 || (n += (size_t)w) >= size) {
+        return -1;
+    }
+    w = snprintf(buf + n, size - n, ",\"tcp\":{\"xmit\":%u,\"drop\":%u,\"memerr\":%u}}",
+                 (unsigned)s.tcp_xmit, (unsigned)s.tcp_drop, (unsigned)s.tcp_memerr);
+    if (w < 0 || (n += (size_t)w) >= size) {
+        return -1;
+    }
+    return (int)n;
+}
+
+void net_stats_print(void) {
+    net_stats_t s;
+    net_stats_get(&s);
+    printf("DEBUG: Memoria do lwIP (perfil %s):\n", LWIP_PROFILE_NAME);
+    for (int i = 0; i < NET_STATS_POOL_COUNT; i++) {
+        const net_stats_pool_t *p = &s.pools[i];
+        printf("DEBUG:   %-14s em uso %u, maximo %u de %u, falhas %u\n",
+               pool_names[i], (unsigned)p->used, (unsigned)p->max, (unsigned)p->avail, (unsigned)p->err);
+    }
+    printf("DEBUG:   tcp            enviados %u, descartados %u, falhas de memoria %u\n",
+           (unsigned)s.tcp_xmit, (unsigned)s.tcp_drop, (unsigned)s.tcp_memerr);
+}
@@ -0,0 +1,50 @@
+#ifndef NET_STATS_H
+#define NET_STATS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Uso de um pool de memória do lwIP (ou do heap)
+typedef struct {
+    uint32_t used;      // Blocos (ou bytes, no heap) em uso agora
+    uint32_t max;       // Maior uso desde o boot (high-water mark)
+    uint32_t avail;     // Capacidade configurada em lwipopts.h (0 no heap da libc, em modo poll)
+    uint32_t err;       // Alocações recusadas por falta de memória
+} net_stats_pool_t;
+
+// Pools acompanhados
+typedef enum {
+    NET_STATS_HEAP = 0,         // Heap (MEM_SIZE): pbufs PBUF_RAM, como os dados copiados por tcp_write()
+    NET_STATS_PBUF_POOL,        // Pbufs de recepção (PBUF_POOL_SIZE)
+    NET_STATS_PBUF_REF,         // Pbufs que apontam para dados externos (PBUF_ROM/PBUF_REF)
+    NET_STATS_TCP_SEG,          // Segmentos TCP na fila de envio (MEMP_NUM_TCP_SEG)
+    NET_STATS_TCP_PCB,          // Conexões TCP, incluindo TIME_WAIT (MEMP_NUM_TCP_PCB)
+    NET_STATS_TCP_PCB_LISTEN,   // Servidores TCP
+    NET_STATS_UDP_PCB,          // Sockets UDP: DNS, DHCP, telemetria, SNTP (MEMP_NUM_UDP_PCB)
+    NET_STATS_SYS_TIMEOUT,      // Temporizadores sys_timeout() ativos (MEMP_NUM_SYS_TIMEOUT)
+    NET_STATS_POOL_COUNT
+} net_stats_pool_id_t;
+
+// Retrato do uso de memória do lwIP
+typedef struct {
+    net_stats_pool_t pools[NET_STATS_POOL_COUNT];
+    uint32_t tcp_xmit;          // Segmentos TCP transmitidos
+    uint32_t tcp_drop;          // Segmentos TCP descartados na recepção
+    uint32_t tcp_memerr;        // Falhas de memória dentro do TCP
+} net_stats_t;
+
+// Nome curto do pool (ex.: "tcp_seg")
+const char *net_stats_pool_name(net_stats_pool_id_t id);
+
+// Copia os contadores do lwIP.
+// Pode ser chamada fora do contexto do lwIP (usa cyw43_arch_lwip_begin/end).
+void net_stats_get(net_stats_t *out);
+
+// Escreve os contadores em JSON, com o perfil de memória em uso (LWIP_PROFILE_NAME).
+// Retorna o tamanho escrito ou -1 se não couber em "size".
+int net_stats_format_json(char *buf, size_t size);
+
+// Registra os contadores no log serial, um pool por linha
+void net_stats_print(void);
+
+#endif // NET_STATS_H
@@ -0,0 +1,315 @@
+#include "result_log.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "pico/flash.h"         // flash_safe_execute()
+#include "pico/cyw43_arch.h"    // cyw43_arch_lwip_begin()/end()
+#include "wifi_link.h"          // Estado do enlace
+#include "lwip/timeouts.h"      // sys_timeout() para o repasse
+
+#define RECORDS_PER_PAGE (FLASH_PAGE_SIZE / RESULT_LOG_RECORD_SIZE)
+#define RECORDS_PER_SECTOR (FLASH_SECTOR_SIZE / RESULT_LOG_RECORD_SIZE)
+#define LOG_CAPACITY (RESULT_LOG_SIZE / RESULT_LOG_RECORD_SIZE)
+
+// ----- Estado do anel -----
+// Os contadores são números de sequência que crescem livremente; a posição de
+// um registro no anel é "seq % LOG_CAPACITY". Vale sempre
+// confirmed <= forwarded <= write_seq.
+static uint32_t write_seq;        // Próximo registro a gravar
+static uint32_t forwarded;        // Próximo registro a repassar à fila HTTP
+static uint32_t confirmed;        // Registro pendente mais antigo
+static uint8_t page_buf[FLASH_PAGE_SIZE];   // Página em preenchimento (a de write_seq)
+static bool page_dirty;           // page_buf tem registros ainda não gravados
+static uint32_t skip_confirms;    // Confirmações de registros reciclados enquanto estavam na fila HTTP
+static bool forwarding;           // Repasse ativo: o estado passa a ser protegido pelo lock do lwIP
+static bool available;            // Região livre do programa (conferido em result_log_init())
+static result_log_stats_t stats;
+
+// ----- Acesso à flash -----
+typedef struct {
+    uint32_t offset;
+    const uint8_t *data;          // NULL para apagar um setor
+} flash_op_t;
+
+static void result_log_flash_op(void *param) {
+    const flash_op_t *op = (const flash_op_t *)param;
+    if (op->data) {
+        flash_range_program(op->offset, op->data, FLASH_PAGE_SIZE);
+    } else {
+        flash_range_erase(op->offset, FLASH_SECTOR_SIZE);
+    }
+}
+
+// Executa a operação com as interrupções (e o outro núcleo) pausados
+static bool result_log_flash(uint32_t offset, const uint8_t *data) {
+    flash_op_t op = { offset, data };
+    return flash_safe_execute(result_log_flash_op, &op, 100) == PICO_OK;
+}
+
+static inline uint32_t record_offset(uint32_t seq) {
+    return RESULT_LOG_OFFSET + (seq % LOG_CAPACITY) * RESULT_LOG_RECORD_SIZE;
+}
+
+static inline uint32_t page_offset(uint32_t seq) {
+    return record_offset(seq) & ~(FLASH_PAGE_SIZE - 1);
+}
+
+// Registro lido pela XIP, ou do buffer se ainda estiver só na RAM
+static const uint8_t *record_at(uint32_t seq) {
+    if (seq / RECORDS_PER_PAGE == write_seq / RECORDS_PER_PAGE) {
+        return page_buf + (seq % RECORDS_PER_PAGE) * RESULT_LOG_RECORD_SIZE;
+    }
+    return (const uint8_t *)(XIP_BASE + record_offset(seq));
+}
+
+static uint8_t crc8(const uint8_t *r) {
+    uint8_t crc = 0;
+    for (int i = 0; i < RESULT_LOG_RECORD_SIZE; i++) {
+        if (i == 1 || (i >= 13 && i < 16)) {
+            continue;  // O byte "enviado" muda depois da gravação; 13..15 são o próprio crc e reserva
+        }
+        crc ^= r[i];
+        for (int b = 0; b < 8; b++) {
+            crc = crc & 0x80 ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+static uint64_t get_u64(const uint8_t *p) {
+    uint64_t v = 0;
+    for (int i = 7; i >= 0; i--) {
+        v = (v << 8) | p[i];
+    }
+    return v;
+}
+
+static void put_u64(uint8_t *p, uint64_t v) {
+    for (int i = 0; i < 8; i++) {
+        p[i] = (uint8_t)(v >> (8 * i));
+    }
+}
+
+static uint32_t record_seq(const uint8_t *r) {
+    return (uint32_t)r[2] | ((uint32_t)r[3] << 8) | ((uint32_t)r[4] << 16) | ((uint32_t)r[5] << 24);
+}
+
+static bool record_valid(const uint8_t *r) {
+    return r[0] == RESULT_LOG_MAGIC && r[13] == crc8(r);
+}
+
+static void record_to_round(const uint8_t *r, game_round_t *round) {
+    round->round = (uint16_t)(r[6] | (r[7] << 8));
+    round->expected_red = r[8];
+    round->user_red = r[9];
+    round->expected_blue = r[10];
+    round->user_blue = r[11];
+    round->success = r[12] & 0x01;
+    round->start_us = get_u64(r + 16);
+    round->end_us = get_u64(r + 24);
+}
+
+static inline void log_lock(void) {
+    if (forwarding) {
+        cyw43_arch_lwip_begin();
+    }
+}
+
+static inline void log_unlock(void) {
+    if (forwarding) {
+        cyw43_arch_lwip_end();
+    }
+}
+
+// Grava a página atual (registros já gravados são reescritos com os mesmos bits)
+static void result_log_program_page(void) {
+    if (page_dirty && result_log_flash(page_offset(write_seq - 1), page_buf)) {
+        page_dirty = false;
+    }
+}
+
+// Marca na flash como enviados os registros [from, to). Programar 0xFF não altera
+// a célula, então cada página recebe uma imagem só com os bytes "enviado" zerados.
+static void result_log_mark_sent(uint32_t from, uint32_t to) {
+    static uint8_t marks[FLASH_PAGE_SIZE];
+    while (from < to) {
+        uint32_t page = from / RECORDS_PER_PAGE;
+        memset(marks, 0xFF, sizeof(marks));
+        for (; from < to && from / RECORDS_PER_PAGE == page; from++) {
+            uint32_t i = (from % RECORDS_PER_PAGE) * RESULT_LOG_RECORD_SIZE + 1;
+            marks[i] = 0x00;
+            if (page == write_seq / RECORDS_PER_PAGE) {
+                page_buf[i] = 0x00;  // Mantém o buffer coerente com a flash
+            }
+        }
+        result_log_flash(page_offset(from - 1), marks);
+    }
+}
+
+// Fim do programa na flash, definido pelo linker script do SDK
+extern char __flash_binary_end;
+
+bool result_log_init(void) {
+    // A região é só presumida livre: um binário maior ou uma placa com outra
+    // PICO_FLASH_SIZE_BYTES a sobreporia, e apagar um setor destruiria o programa
+    uintptr_t binary_end = (uintptr_t)&__flash_binary_end;
+    if (binary_end > XIP_BASE + RESULT_LOG_OFFSET) {
+        printf("DEBUG: ERRO: programa (%u bytes) invade o log em flash (offset %u); log desativado\n",
+               (unsigned)(binary_end - XIP_BASE), (unsigned)RESULT_LOG_OFFSET);
+        available = false;
+        return false;
+    }
+    available = true;
+
+    // Último registro válido: a escrita continua depois dele
+    bool found = false;
+    uint32_t last = 0;
+    for (uint32_t i = 0; i < LOG_CAPACITY; i++) {
+        const uint8_t *r = (const uint8_t *)(XIP_BASE + RESULT_LOG_OFFSET + i * RESULT_LOG_RECORD_SIZE);
+        if (record_valid(r) && record_seq(r) % LOG_CAPACITY == i &&
+            (!found || (int32_t)(record_seq(r) - last) > 0)) {
+            last = record_seq(r);
+            found = true;
+        }
+    }
+    write_seq = found ? last + 1 : 0;
+
+    // Pendente mais antigo: os registros são confirmados em ordem, então
+    // tudo antes do primeiro pendente já foi enviado
+    uint32_t oldest = write_seq > LOG_CAPACITY ? write_seq - LOG_CAPACITY : 0;
+    confirmed = write_seq;
+    for (uint32_t seq = oldest; seq < write_seq; seq++) {
+        const uint8_t *r = (const uint8_t *)(XIP_BASE + record_offset(seq));
+        if (record_valid(r) && record_seq(r) == seq && r[1] == 0xFF) {
+            confirmed = seq;
+            break;
+        }
+    }
+    forwarded = confirmed;
+
+    // Página parcial: continua a partir do conteúdo já gravado
+    if (write_seq % RECORDS_PER_PAGE) {
+        memcpy(page_buf, (const uint8_t *)(XIP_BASE + page_offset(write_seq)), FLASH_PAGE_SIZE);
+    } else {
+        memset(page_buf, 0xFF, sizeof(page_buf));
+    }
+    page_dirty = false;
+    printf("DEBUG: Log em flash: %u registros pendentes\n", (unsigned)(write_seq - confirmed));
+    return true;
+}
+
+bool result_log_append(const game_round_t *round) {
+    if (!available) {
+        return false;
+    }
+    log_lock();
+    // Início de setor: recicla o setor mais antigo do anel
+    if (write_seq % RECORDS_PER_SECTOR == 0) {
+        uint32_t reclaimed = write_seq >= LOG_CAPACITY ? write_seq - LOG_CAPACITY + RECORDS_PER_SECTOR : 0;
+        if (confirmed < reclaimed) {
+            // Os já repassados seguem na fila HTTP; suas confirmações serão ignoradas
+            uint32_t in_queue = (forwarded < reclaimed ? forwarded : reclaimed) - confirmed;
+            skip_confirms += in_queue;
+            stats.overwritten += reclaimed - confirmed - in_queue;
+            confirmed = reclaimed;
+        }
+        if (forwarded < confirmed) {
+            forwarded = confirmed;
+        }
+        result_log_flash(record_offset(write_seq), NULL);
+        stats.erases++;
+    }
+
+    uint8_t *r = page_buf + (write_seq % RECORDS_PER_PAGE) * RESULT_LOG_RECORD_SIZE;
+    r[0] = RESULT_LOG_MAGIC;
+    r[1] = 0xFF;
+    r[2] = (uint8_t)write_seq;
+    r[3] = (uint8_t)(write_seq >> 8);
+    r[4] = (uint8_t)(write_seq >> 16);
+    r[5] = (uint8_t)(write_seq >> 24);
+    r[6] = (uint8_t)round->round;
+    r[7] = (uint8_t)(round->round >> 8);
+    r[8] = round->expected_red;
+    r[9] = round->user_red;
+    r[10] = round->expected_blue;
+    r[11] = round->user_blue;
+    r[12] = round->success ? 0x01 : 0x00;
+    r[14] = 0xFF;
+    r[15] = 0xFF;
+    put_u64(r + 16, round->start_us);
+    put_u64(r + 24, round->end_us);
+    r[13] = crc8(r);
+    write_seq++;
+    page_dirty = true;
+
+    // Página cheia: vai para a flash e o buffer passa para a próxima
+    if (write_seq % RECORDS_PER_PAGE == 0) {
+        result_log_program_page();
+        memset(page_buf, 0xFF, sizeof(page_buf));
+    }
+    log_unlock();
+    return true;
+}
+
+// Rodadas confirmadas pela fila HTTP (contexto do lwIP), sempre as mais antigas
+static void result_log_confirmed(uint32_t count) {
+    uint32_t skip = count < skip_confirms ? count : skip_confirms;
+    skip_confirms -= skip;
+    count -= skip;
+
+    uint32_t from = confirmed;
+    uint32_t to = from + count;
+    if (to > forwarded) {
+        to = forwarded;
+    }
+    if (to > from) {
+        result_log_mark_sent(from, to);
+        confirmed = to;
+    }
+}
+
+// Repassa à fila HTTP os registros ainda não entregues (lock do lwIP já obtido)
+static void result_log_forward(void) {
+    if (wifi_link_state() != WIFI_LINK_UP) {
+        return;  // Sem rede: os registros esperam na flash
+    }
+    while (forwarded < write_seq && result_queue_space() > 0) {
+        game_round_t round;
+        record_to_round(record_at(forwarded), &round);
+        if (!result_queue_push(&round)) {
+            break;
+        }
+        forwarded++;
+    }
+}
+
+static void result_log_timer(void *arg) {
+    result_log_forward();
+    sys_timeout(RESULT_LOG_FORWARD_MS, result_log_timer, NULL);
+}
+
+void result_log_flush(void) {
+    log_lock();
+    result_log_program_page();
+    if (forwarding) {
+        result_log_forward();
+    }
+    log_unlock();
+}
+
+void result_log_start_forwarding(void) {
+    cyw43_arch_lwip_begin();
+    forwarding = true;
+    result_queue_set_confirm_fn(result_log_confirmed);
+    sys_timeout(RESULT_LOG_FORWARD_MS, result_log_timer, NULL);
+    cyw43_arch_lwip_end();
+}
+
+void result_log_get_stats(result_log_stats_t *out) {
+    log_lock();
+    *out = stats;
+    out->stored = write_seq - confirmed;
+    out->unforwarded = write_seq - forwarded;
+    log_unlock();
+}
@@ -0,0 +1,66 @@
+#ifndef RESULT_LOG_H
+#define RESULT_LOG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "hardware/flash.h"   // FLASH_SECTOR_SIZE, FLASH_PAGE_SIZE
+#include "result_queue.h"     // game_round_t
+
+// ----- Região reservada na flash -----
+// Últimos RESULT_LOG_SECTORS setores da flash, fora da área do programa.
+// result_log_init() confere no boot que o binário (__flash_binary_end) termina
+// antes da região; se não terminar, o log fica desativado e nunca apaga a flash.
+#define RESULT_LOG_SECTORS 16
+#define RESULT_LOG_SIZE (RESULT_LOG_SECTORS * FLASH_SECTOR_SIZE)
+#define RESULT_LOG_OFFSET (PICO_FLASH_SIZE_BYTES - RESULT_LOG_SIZE)
+
+// Registro gravado na flash (32 bytes, 8 por página):
+//   0  magic      RESULT_LOG_MAGIC
+//   1  enviado    0xFF = pendente, 0x00 = confirmado pelo servidor (gravado no lugar)
+//   2  seq        uint32 little-endian, define a posição no anel
+//   6  round      uint16
+//   8  expected_red, user_red, expected_blue, user_blue
+//  12  flags      bit 0 = acertou
+//  13  crc8       dos bytes 0, 2..12 e 16..31
+//  14  reservado  0xFF
+//  16  start_us   uint64 little-endian (0 = sem horário)
+//  24  end_us     uint64 little-endian
+// A versão anterior (16 bytes, magic 0x5A) não é reconhecida e é reciclada.
+#define RESULT_LOG_RECORD_SIZE 32
+#define RESULT_LOG_MAGIC 0x5B
+
+// Intervalo do repasse em segundo plano para a fila HTTP
+#define RESULT_LOG_FORWARD_MS 1000
+
+// Contadores do log
+typedef struct {
+    uint32_t stored;        // Registros no anel ainda não confirmados
+    uint32_t unforwarded;   // Registros ainda não repassados à fila HTTP
+    uint32_t overwritten;   // Registros pendentes perdidos ao reciclar um setor
+    uint32_t erases;        // Setores apagados desde o boot
+} result_log_stats_t;
+
+// Varre a região da flash e retoma o anel: a escrita continua após o último
+// registro válido e o repasse parte do registro pendente mais antigo.
+// Deve ser chamada no início, antes de qualquer outra função do log.
+// Retorna false (log desativado) se o programa invadir a região reservada.
+bool result_log_init(void);
+
+// Grava uma rodada. O registro fica no buffer da página e a página vai para
+// a flash quando enche (um setor é apagado a cada 128 registros).
+// Retorna false com o log desativado.
+bool result_log_append(const game_round_t *round);
+
+// Grava na flash a página parcial atual (ex.: fim da partida) e repassa os
+// pendentes à fila HTTP se o enlace estiver ativo
+void result_log_flush(void);
+
+// Inicia o repasse em segundo plano para a fila HTTP (requer o Wi-Fi inicializado
+// e result_queue_init() feito). Registros confirmados pelo servidor são marcados
+// na flash e não são reenviados após um reinício.
+void result_log_start_forwarding(void);
+
+// Cópia dos contadores
+void result_log_get_stats(result_log_stats_t *out);
+
+#endif // RESULT_LOG_H
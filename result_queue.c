@@ -0,0 +1,174 @@
+#include "result_queue.h"
+
+#include <stdio.h>
+
+#include "pico/cyw43_arch.h"  // cyw43_arch_lwip_begin()/end()
+#include "lwip/timeouts.h"    // sys_timeout()/sys_untimeout()
+#include "http_client.h"
+
+// ----- Estado da fila -----
+// Contadores crescem livremente e o índice é o resto. Tudo é acessado com o
+// lock do lwIP, pois o envio periódico e as respostas rodam no contexto dele.
+static game_round_t queue[RESULT_QUEUE_SIZE];
+static uint32_t queue_head;              // Próxima posição livre
+static uint32_t queue_tail;              // Rodada mais antiga ainda não confirmada
+static uint32_t in_flight;               // Rodadas a partir de queue_tail no lote em envio
+static uint32_t dropped;
+
+static const char *upload_path;
+static result_queue_format_t upload_format;
+static uint32_t upload_batch_size;
+static uint32_t upload_interval_ms;
+static result_queue_confirm_fn confirm_fn;
+
+static char body[RESULT_QUEUE_BODY_SIZE];
+
+static bool result_queue_send(void);
+
+// Resposta do lote: 2xx confirma as rodadas; 4xx também as retira, pois reenviar
+// o mesmo conteúdo não adiantaria; falhas de rede e 5xx ficam para o próximo envio.
+static void result_queue_sent(http_client_result_t result, int status, const char *response, void *arg) {
+    uint32_t batch = in_flight;
+    in_flight = 0;
+    if (result == HTTP_CLIENT_OK && status >= 200 && status < 500) {
+        if (status >= 400) {
+            printf("DEBUG: Lote de %u resultados recusado pela API (%d): %s\n", (unsigned)batch, status, response);
+        } else {
+            printf("DEBUG: Lote de %u resultados confirmado (%d)\n", (unsigned)batch, status);
+        }
+        queue_tail += batch;
+        if (confirm_fn) {
+            confirm_fn(batch);
+        }
+        if (queue_head - queue_tail >= upload_batch_size) {
+            result_queue_send();  // Acumulou outro lote enquanto este estava em envio
+        }
+    } else {
+        printf("DEBUG: Falha ao enviar lote de resultados: %d (status %d)\n", result, status);
+    }
+}
+
+// Horário em µs como número JSON, ou null se o relógio não estava sincronizado
+static const char *result_queue_format_time(char *dst, size_t size, uint64_t unix_us) {
+    if (!unix_us) {
+        return "null";
+    }
+    snprintf(dst, size, "%llu", (unsigned long long)unix_us);
+    return dst;
+}
+
+// Serializa uma rodada; retorna o tamanho escrito ou 0 se não couber
+static size_t result_queue_format_round(char *dst, size_t room, const game_round_t *r, bool first) {
+    const char *sep = upload_format == RESULT_QUEUE_NDJSON ? "" : (first ? "" : ",");
+    const char *end = upload_format == RESULT_QUEUE_NDJSON ? "\n" : "";
+    char start[24];
+    char finish[24];
+    int n = snprintf(dst, room,
+                     "%s{\"round\": %u, \"expectedRed\": %u, \"userRed\": %u, \"expectedBlue\": %u, \"userBlue\": %u, \"success\": %s, "
+                     "\"startUs\": %s, \"endUs\": %s}%s",
+                     sep, r->round, r->expected_red, r->user_red, r->expected_blue, r->user_blue,
+                     r->success ? "true" : "false",
+                     result_queue_format_time(start, sizeof(start), r->start_us),
+                     result_queue_format_time(finish, sizeof(finish), r->end_us), end);
+    return n > 0 && (size_t)n < room ? (size_t)n : 0;
+}
+
+// Monta o corpo com o maior lote que couber e o entrega ao cliente HTTP (lock do lwIP já obtido)
+static bool result_queue_send(void) {
+    uint32_t pending = queue_head - queue_tail;
+    if (in_flight || pending == 0) {
+        return false;
+    }
+
+    bool array = upload_format == RESULT_QUEUE_JSON_ARRAY;
+    size_t len = 0;
+    size_t room = sizeof(body) - (array ? 2 : 0);  // Reserva "]" e o terminador
+    if (array) {
+        body[len++] = '[';
+    }
+    uint32_t count = 0;
+    while (count < pending) {
+        const game_round_t *r = &queue[(queue_tail + count) % RESULT_QUEUE_SIZE];
+        size_t n = result_queue_format_round(body + len, room - len, r, count == 0);
+        if (n == 0) {
+            break;  // O restante segue no próximo lote
+        }
+        len += n;
+        count++;
+    }
+    if (array) {
+        body[len++] = ']';
+    }
+    body[len] = '\0';
+
+    // Marcado antes do POST: uma falha imediata de conexão já chama result_queue_sent()
+    in_flight = count;
+    const char *content_type = array ? "application/json" : "application/x-ndjson";
+    if (!http_client_post(upload_path, content_type, body, result_queue_sent, NULL)) {
+        printf("DEBUG: Fila HTTP cheia; lote adiado\n");
+        in_flight = 0;
+        return false;
+    }
+    return true;
+}
+
+// Envio periódico (contexto do lwIP): garante que rodadas não fiquem paradas na fila
+static void result_queue_timer(void *arg) {
+    result_queue_send();
+    sys_timeout(upload_interval_ms, result_queue_timer, NULL);
+}
+
+void result_queue_init(const char *path, result_queue_format_t format, uint32_t batch_size, uint32_t interval_ms) {
+    cyw43_arch_lwip_begin();
+    upload_path = path;
+    upload_format = format;
+    upload_batch_size = batch_size ? batch_size : 1;
+    upload_interval_ms = interval_ms;
+    sys_untimeout(result_queue_timer, NULL);
+    if (interval_ms) {
+        sys_timeout(interval_ms, result_queue_timer, NULL);
+    }
+    cyw43_arch_lwip_end();
+}
+
+bool result_queue_push(const game_round_t *round) {
+    bool ok = false;
+    cyw43_arch_lwip_begin();
+    if (queue_head - queue_tail < RESULT_QUEUE_SIZE) {
+        queue[queue_head % RESULT_QUEUE_SIZE] = *round;
+        queue_head++;
+        ok = true;
+        if (queue_head - queue_tail - in_flight >= upload_batch_size) {
+            result_queue_send();
+        }
+    } else {
+        dropped++;
+    }
+    cyw43_arch_lwip_end();
+    return ok;
+}
+
+bool result_queue_flush(void) {
+    cyw43_arch_lwip_begin();
+    bool sent = result_queue_send();
+    cyw43_arch_lwip_end();
+    return sent;
+}
+
+void result_queue_set_confirm_fn(result_queue_confirm_fn fn) {
+    cyw43_arch_lwip_begin();
+    confirm_fn = fn;
+    cyw43_arch_lwip_end();
+}
+
+uint32_t result_queue_space(void) {
+    return RESULT_QUEUE_SIZE - (queue_head - queue_tail);
+}
+
+uint32_t result_queue_pending(void) {
+    return queue_head - queue_tail;
+}
+
+uint32_t result_queue_dropped(void) {
+    return dropped;
+}
@@ -0,0 +1,61 @@
+#ifndef RESULT_QUEUE_H
+#define RESULT_QUEUE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Rodadas guardadas à espera de envio
+#define RESULT_QUEUE_SIZE 32
+
+// Corpo máximo de um lote (deve caber em HTTP_CLIENT_REQUEST_SIZE junto com o cabeçalho)
+#define RESULT_QUEUE_BODY_SIZE 1408
+
+// Resultado de uma rodada
+typedef struct {
+    uint16_t round;
+    uint8_t expected_red;
+    uint8_t user_red;
+    uint8_t expected_blue;
+    uint8_t user_blue;
+    bool success;
+    uint64_t start_us;      // Exibição do padrão, em µs desde 1970 UTC (0 = relógio ainda não sincronizado)
+    uint64_t end_us;        // Fim do tempo de resposta, na mesma escala
+} game_round_t;
+
+// Formato do corpo de um lote
+typedef enum {
+    RESULT_QUEUE_JSON_ARRAY = 0,   // [{...},{...}] com Content-Type application/json
+    RESULT_QUEUE_NDJSON            // Um objeto por linha com Content-Type application/x-ndjson
+} result_queue_format_t;
+
+// Chamado (contexto do lwIP) quando as "count" rodadas mais antigas saem da fila
+// por terem sido aceitas ou recusadas em definitivo pelo servidor
+typedef void (*result_queue_confirm_fn)(uint32_t count);
+
+// Configura a fila. Os resultados são enviados em um único POST para "path"
+// quando "batch_size" rodadas se acumulam, a cada "interval_ms" (0 desativa o
+// envio periódico) ou quando result_queue_flush() é chamada. Requer
+// http_client_init() já feito.
+void result_queue_init(const char *path, result_queue_format_t format, uint32_t batch_size, uint32_t interval_ms);
+
+// Guarda o resultado de uma rodada; só toca na rede se o lote atingiu
+// "batch_size". Retorna false (e conta um descarte) se a fila estiver cheia.
+bool result_queue_push(const game_round_t *round);
+
+// Envia agora as rodadas pendentes (ex.: fim da partida). Retorna false se não
+// havia nada para enviar ou se um lote anterior ainda aguarda resposta.
+bool result_queue_flush(void);
+
+// Registra quem deve ser avisado das rodadas confirmadas (ex.: o log em flash)
+void result_queue_set_confirm_fn(result_queue_confirm_fn fn);
+
+// Posições livres na fila
+uint32_t result_queue_space(void);
+
+// Rodadas ainda não confirmadas pelo servidor
+uint32_t result_queue_pending(void);
+
+// Rodadas descartadas por fila cheia
+uint32_t result_queue_dropped(void);
+
+#endif // RESULT_QUEUE_H
@@ -0,0 +1,81 @@
+"""Servidor local que imita as rotas de resultados da API para testes da placa.
+
+Não depende do Flask nem do Telegram: apenas valida, imprime e guarda em
+memória os resultados recebidos. Usa HTTP/1.1 (conexões keep-alive), como a
+placa espera. Uso:
+
+    python3 LocalStandIn.py [porta]
+
+GET /game_results devolve tudo o que foi recebido e quantos POSTs chegaram.
+"""
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+import json
+import sys
+import time
+
+REQUIRED_FIELDS = ['round', 'expectedRed', 'userRed', 'expectedBlue', 'userBlue', 'success']
+
+# Resultados recebidos e número de requisições (para comparar envio unitário x lote)
+received = []
+post_count = 0
+
+
+def parse_body(content_type, raw):
+    """Converte o corpo em lista de resultados (objeto, array JSON ou NDJSON)."""
+    text = raw.decode('utf-8')
+    if content_type.startswith('application/x-ndjson'):
+        return [json.loads(line) for line in text.splitlines() if line.strip()]
+    data = json.loads(text)
+    return data if isinstance(data, list) else [data]
+
+
+class StandInHandler(BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"  # Mantém a conexão aberta entre requisições
+
+    def send_json(self, status, payload):
+        body = json.dumps(payload).encode('utf-8')
+        self.send_response(status)
+        self.send_header('Content-Type', 'application/json')
+        self.send_header('Content-Length', str(len(body)))
+        self.end_headers()
+        self.wfile.write(body)
+
+    def do_GET(self):
+        if self.path in ('/game_result', '/game_results'):
+            self.send_json(200, {"game_results": received, "count": len(received), "posts": post_count})
+        else:
+            self.send_json(404, {"error": "rota desconhecida"})
+
+    def do_POST(self):
+        global post_count
+        length = int(self.headers.get('Content-Length', 0))
+        raw = self.rfile.read(length)
+        if self.path not in ('/game_result', '/game_results'):
+            self.send_json(404, {"error": "rota desconhecida"})
+            return
+        try:
+            batch = parse_body(self.headers.get('Content-Type', ''), raw)
+        except (ValueError, UnicodeDecodeError):
+            batch = None
+        if not batch or not all(isinstance(r, dict) and all(f in r for f in REQUIRED_FIELDS) for r in batch):
+            self.send_json(400, {"error": "Dados incompletos. Campos requeridos: " + ", ".join(REQUIRED_FIELDS)})
+            return
+
+        post_count += 1
+        received_us = time.time_ns() // 1000
+        for r in batch:
+            r['receivedUs'] = received_us
+        received.extend(batch)
+        for r in batch:
+            # Atraso entre o fim da rodada na placa (relógio SNTP) e a chegada aqui
+            delay = f", chegou {(received_us - r['endUs']) / 1000:.1f} ms depois" if r.get('endUs') else ""
+            print(f"Rodada {r['round']}: {'acertou' if r['success'] else 'errou'} "
+                  f"(vermelho {r['userRed']}/{r['expectedRed']}, azul {r['userBlue']}/{r['expectedBlue']}){delay}")
+        print(f"POST {self.path}: {len(batch)} resultado(s); total {len(received)} em {post_count} requisição(ões)")
+        self.send_json(200, {"status": "success", "count": len(batch)})
+
+
+if __name__ == '__main__':
+    port = int(sys.argv[1]) if len(sys.argv) > 1 else 5000
+    print(f"Servidor de teste escutando na porta {port}")
+    ThreadingHTTPServer(('0.0.0.0', port), StandInHandler).serve_forever()
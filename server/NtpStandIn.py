@@ -0,0 +1,51 @@
+"""Servidor SNTP mínimo para a placa sincronizar o relógio na rede local.
+
+Responde às consultas com a hora desta máquina (RFC 4330, estrato 2) e devolve
+o carimbo de envio do cliente no campo "originate", como a placa espera. Use
+quando a rede não tiver um servidor NTP; a porta padrão (123) exige privilégio:
+
+    sudo python3 NtpStandIn.py [porta]
+"""
+import socket
+import struct
+import sys
+import time
+
+NTP_UNIX_OFFSET = 2208988800   # Segundos entre 1900 e 1970
+MODE_CLIENT = 3
+MODE_SERVER = 4
+PACKET = struct.Struct("!BBbbII4sQQQQ")  # LI/VN/modo, estrato, poll, precisão, atraso, dispersão, ref id, 4 carimbos
+
+
+def ntp_timestamp(unix_time):
+    """Hora Unix (float) em carimbo NTP de 64 bits."""
+    seconds = int(unix_time) + NTP_UNIX_OFFSET
+    fraction = int((unix_time % 1) * (1 << 32))
+    return ((seconds & 0xFFFFFFFF) << 32) | fraction
+
+
+def main():
+    port = int(sys.argv[1]) if len(sys.argv) > 1 else 123
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.bind(("0.0.0.0", port))
+    print(f"Servidor NTP de teste escutando na porta UDP {port}")
+
+    while True:
+        data, addr = sock.recvfrom(512)
+        received = time.time()
+        if len(data) < PACKET.size:
+            continue
+        fields = PACKET.unpack_from(data)
+        version = (fields[0] >> 3) & 0x07
+        if fields[0] & 0x07 != MODE_CLIENT:
+            continue
+        client_transmit = fields[10]
+        reference = ntp_timestamp(received)
+        reply = PACKET.pack((version << 3) | MODE_SERVER, 2, fields[2], -20, 0, 0, b"LOCL",
+                            reference, client_transmit, reference, ntp_timestamp(time.time()))
+        sock.sendto(reply, addr)
+        print(f"Hora enviada para {addr[0]}:{addr[1]}")
+
+
+if __name__ == '__main__':
+    main()
@@ -1,4 +1,5 @@
 from flask import Flask, request, jsonify
+from werkzeug.serving import WSGIRequestHandler
 import requests
 import os
 import time
@@ -69,49 +70,70 @@ def send_telegram_notification(message):
 
 @app.route('/')
 def index():
-    return "Servidor rodando! Use /game_result para enviar resultados, /rank para consultar os resultados via GET e /webhook para atualizações do Telegram."
+    return "Servidor rodando! Use /game_result para enviar resultados, /game_results para enviar lotes, /rank para consultar os resultados via GET e /webhook para atualizações do Telegram."
+
+REQUIRED_FIELDS = ['round', 'expectedRed', 'userRed', 'expectedBlue', 'userBlue', 'success']
+
+def is_valid_result(data):
+    """Verifica se um resultado tem todos os campos requeridos."""
+    return isinstance(data, dict) and all(field in data for field in REQUIRED_FIELDS)
+
+def format_result_message(data):
+    """Monta a linha de notificação de uma rodada."""
+    return (
+        f"{'✅' if data['success'] else '❌'} <b>Rodada {data['round']} - {'Acertou!' if data['success'] else 'Errou!'}</b>\n"
+        f"Vermelho: {data['userRed']} (esperado: {data['expectedRed']})\n"
+        f"Azul: {data['userBlue']} (esperado: {data['expectedBlue']})"
+    )
+
+def start_record_conversation(data):
+    """Guarda o recorde pendente de uma rodada perdida e pergunta se deve ser salvo."""
+    global pending_record, conversation_state
+    pending_record = {
+        "round": data['round'],
+        "expectedRed": data['expectedRed'],
+        "userRed": data['userRed'],
+        "expectedBlue": data['expectedBlue'],
+        "userBlue": data['userBlue'],
+        # Horário da placa (SNTP) quando disponível; senão, o da chegada
+        "timestamp": data['endUs'] / 1e6 if data.get('endUs') else time.time()
+    }
+    conversation_state = "ask_confirmation"
+    send_telegram_notification("❌ Você errou!\nDeseja salvar o recorde? Responda com <b>sim</b> ou <b>nao</b>.")
+
+def stamp_arrival(results):
+    """Registra a chegada em µs, para comparar com os horários da placa (startUs/endUs)."""
+    received_us = time.time_ns() // 1000
+    for data in results:
+        data['receivedUs'] = received_us
+
+def parse_batch(req):
+    """Lê um lote enviado como array JSON ou NDJSON (um objeto por linha)."""
+    if req.mimetype == 'application/x-ndjson':
+        lines = req.get_data(as_text=True).splitlines()
+        return [json.loads(line) for line in lines if line.strip()]
+    data = req.get_json()
+    return data if isinstance(data, list) else None
 
 @app.route('/game_result', methods=['GET', 'POST'])
 def game_result():
-    global game_results, pending_record, conversation_state
+    global game_results
 
     if request.method == 'POST':
         data = request.get_json()
-        required_fields = ['round', 'expectedRed', 'userRed', 'expectedBlue', 'userBlue', 'success']
-        if not data or not all(field in data for field in required_fields):
+        if not data or not is_valid_result(data):
             return jsonify({"error": "Dados incompletos. Campos requeridos: round, expectedRed, userRed, expectedBlue, userBlue, success."}), 400
 
-        round_number = data['round']
-        expectedRed = data['expectedRed']
-        userRed = data['userRed']
-        expectedBlue = data['expectedBlue']
-        userBlue = data['userBlue']
-        success = data['success']
-
-        # Monta a mensagem para notificação no Telegram
-        message = (
-            f"{'✅' if success else '❌'} <b>Rodada {round_number} - {'Acertou!' if success else 'Errou!'}</b>\n"
-            f"Vermelho: {userRed} (esperado: {expectedRed})\n"
-            f"Azul: {userBlue} (esperado: {expectedBlue})"
-        )
-
-        telegram_response = send_telegram_notification(message)
+        # Notificação da rodada no Telegram
+        telegram_response = send_telegram_notification(format_result_message(data))
 
+        stamp_arrival([data])
         game_results.append(data)
         save_data()  # Salva os resultados imediatamente
 
         # Se o jogador errou, inicia o processo para salvar o recorde
-        if not success:
-            pending_record = {
-                "round": round_number,
-                "expectedRed": expectedRed,
-                "userRed": userRed,
-                "expectedBlue": expectedBlue,
-                "userBlue": userBlue,
-                "timestamp": time.time()
-            }
-            conversation_state = "ask_confirmation"
-            send_telegram_notification("❌ Você errou!\nDeseja salvar o recorde? Responda com <b>sim</b> ou <b>nao</b>.")
+        if not data['success']:
+            start_record_conversation(data)
 
         return jsonify({
             "status": "success",
@@ -122,6 +144,33 @@ def game_result():
     elif request.method == 'GET':
         return jsonify({"game_results": game_results, "count": len(game_results)}), 200
 
+@app.route('/game_results', methods=['POST'])
+def game_results_batch():
+    """Recebe várias rodadas de uma vez (array JSON ou NDJSON) e envia uma única notificação."""
+    try:
+        batch = parse_batch(request)
+    except (ValueError, json.JSONDecodeError):
+        batch = None
+    if not batch or not all(is_valid_result(data) for data in batch):
+        return jsonify({"error": "Lote inválido. Envie um array JSON ou NDJSON de resultados com os campos: round, expectedRed, userRed, expectedBlue, userBlue, success."}), 400
+
+    telegram_response = send_telegram_notification("\n\n".join(format_result_message(data) for data in batch))
+
+    stamp_arrival(batch)
+    game_results.extend(batch)
+    save_data()  # Salva o lote inteiro de uma vez
+
+    # A última rodada perdida do lote é a que encerrou a partida
+    lost = [data for data in batch if not data['success']]
+    if lost:
+        start_record_conversation(lost[-1])
+
+    return jsonify({
+        "status": "success",
+        "count": len(batch),
+        "telegram_response": telegram_response
+    }), 200
+
 @app.route('/rank', methods=['GET'])
 def get_rank():
     """Retorna os recordes salvos, ordenados pela fase (round) de forma decrescente."""
@@ -171,4 +220,6 @@ def webhook():
 
 if __name__ == '__main__':
     load_data()  # Carregar os dados antes de iniciar
+    # HTTP/1.1 mantém a conexão aberta entre requisições (a placa reutiliza a mesma conexão)
+    WSGIRequestHandler.protocol_version = "HTTP/1.1"
     app.run(host='0.0.0.0', port=5000, debug=True)
\ No newline at end of file
@@ -0,0 +1,102 @@
+"""Receptor da telemetria UDP da placa (ver telemetry.h para o formato).
+
+Confirma cada registro recebido, descarta retransmissões já vistas e grava
+as rodadas em game_results.json no mesmo formato usado pelo TelegramServer.py.
+Uso:
+
+    python3 TelemetryReceiver.py [porta]
+"""
+from collections import deque
+import json
+import os
+import socket
+import struct
+import sys
+import time
+
+GAME_RESULTS_FILE = "game_results.json"
+
+MAGIC = b"LR"
+VERSION = 3
+TYPE_ROUND = 1
+TYPE_ACK = 2
+
+HEADER = struct.Struct("<2sBBIIII")  # magic, versão, tipo, device_id, session, seq, timestamp_ms
+ROUND = struct.Struct("<HBBBBBQQ")   # round, expected_red, user_red, expected_blue, user_blue, flags, start_us, end_us
+
+# Sequências recentes da sessão atual de cada dispositivo, para ignorar registros
+# reenviados. O seq recomeça a cada boot; uma sessão nova descarta o histórico.
+SEEN_HISTORY = 1024
+seen = {}
+
+
+def load_results():
+    if os.path.exists(GAME_RESULTS_FILE):
+        with open(GAME_RESULTS_FILE, "r", encoding="utf-8") as f:
+            try:
+                return json.load(f)
+            except json.JSONDecodeError:
+                pass
+    return []
+
+
+def save_results(results):
+    with open(GAME_RESULTS_FILE, "w", encoding="utf-8") as f:
+        json.dump(results, f, indent=4, ensure_ascii=False)
+
+
+def already_seen(device_id, session, seq):
+    history = seen.get(device_id)
+    if history is None or history[0] != session:
+        history = (session, deque(maxlen=SEEN_HISTORY), set())
+        seen[device_id] = history
+    _, order, members = history
+    if seq in members:
+        return True
+    if len(order) == order.maxlen:
+        members.discard(order[0])
+    order.append(seq)
+    members.add(seq)
+    return False
+
+
+def main():
+    port = int(sys.argv[1]) if len(sys.argv) > 1 else 5005
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.bind(("0.0.0.0", port))
+    print(f"Receptor de telemetria escutando na porta UDP {port}")
+    results = load_results()
+
+    while True:
+        data, addr = sock.recvfrom(512)
+        if len(data) < HEADER.size + ROUND.size:
+            continue
+        magic, version, kind, device_id, session, seq, timestamp_ms = HEADER.unpack_from(data)
+        if magic != MAGIC or version != VERSION or kind != TYPE_ROUND:
+            continue
+
+        # Confirma sempre, inclusive duplicatas: a confirmação anterior pode ter se perdido
+        sock.sendto(HEADER.pack(MAGIC, VERSION, TYPE_ACK, device_id, session, seq, timestamp_ms), addr)
+        if already_seen(device_id, session, seq):
+            continue
+
+        (round_number, expected_red, user_red, expected_blue, user_blue, flags,
+         start_us, end_us) = ROUND.unpack_from(data, HEADER.size)
+        result = {
+            "round": round_number,
+            "expectedRed": expected_red,
+            "userRed": user_red,
+            "expectedBlue": expected_blue,
+            "userBlue": user_blue,
+            "success": bool(flags & 0x01),
+            "startUs": start_us or None,   # 0: relógio da placa ainda não sincronizado
+            "endUs": end_us or None,
+            "receivedUs": time.time_ns() // 1000
+        }
+        results.append(result)
+        save_results(results)
+        print(f"[{device_id:08x}/{session:08x} #{seq} t={timestamp_ms} ms] {json.dumps(result)}")
+
+
+if __name__ == '__main__':
+    main()
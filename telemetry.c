@@ -0,0 +1,251 @@
+#include "telemetry.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "pico/stdlib.h"       // to_ms_since_boot()
+#include "pico/unique_id.h"    // ID único da placa
+#include "pico/rand.h"         // Sessão sorteada a cada boot
+#include "pico/cyw43_arch.h"   // cyw43_arch_lwip_begin()/end()
+#include "lwip/udp.h"
+#include "lwip/timeouts.h"     // sys_timeout() para as retransmissões
+#include "lwip/dns.h"          // Resolução do nome do receptor
+#include "wifi_link.h"         // Envios só com o enlace ativo
+
+// Registro aguardando confirmação
+typedef struct {
+    bool used;
+    uint8_t sends;                              // Envios já feitos
+    uint32_t seq;
+    uint32_t last_send_ms;
+    uint8_t data[TELEMETRY_ROUND_SIZE];         // Datagrama pronto para reenvio
+} telemetry_slot_t;
+
+// ----- Estado do transporte (acessado com o lock do lwIP) -----
+static struct udp_pcb *pcb;
+static const char *remote_host;
+static ip_addr_t remote_addr;
+static bool resolved;                   // remote_addr válido (resultado do DNS em cache)
+static bool resolving;
+static uint16_t remote_port;
+static uint32_t device_id;
+static uint32_t session;
+static uint32_t next_seq;
+static telemetry_slot_t window[TELEMETRY_WINDOW];
+static uint32_t in_window;
+static bool retry_armed;
+static telemetry_stats_t stats;
+
+static void put_u16(uint8_t *p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_u32(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static void put_u64(uint8_t *p, uint64_t v) {
+    put_u32(p, (uint32_t)v);
+    put_u32(p + 4, (uint32_t)(v >> 32));
+}
+
+static uint32_t get_u32(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void telemetry_put_header(uint8_t *p, uint8_t type, uint32_t seq, uint32_t timestamp_ms) {
+    p[0] = TELEMETRY_MAGIC_0;
+    p[1] = TELEMETRY_MAGIC_1;
+    p[2] = TELEMETRY_VERSION;
+    p[3] = type;
+    put_u32(p + 4, device_id);
+    put_u32(p + 8, session);
+    put_u32(p + 12, seq);
+    put_u32(p + 16, timestamp_ms);
+}
+
+// ID de 32 bits a partir dos 64 bits do ID único da flash (FNV-1a)
+static uint32_t telemetry_device_id(void) {
+    pico_unique_board_id_t id;
+    pico_get_unique_board_id(&id);
+    uint32_t h = 2166136261u;
+    for (int i = 0; i < PICO_UNIQUE_BOARD_ID_SIZE_BYTES; i++) {
+        h = (h ^ id.id[i]) * 16777619u;
+    }
+    return h;
+}
+
+static err_t telemetry_transmit(telemetry_slot_t *slot);
+
+// Resposta do DNS: envia os registros que aguardavam o endereço
+static void telemetry_dns_found(const char *name, const ip_addr_t *ipaddr, void *arg) {
+    resolving = false;
+    if (!ipaddr) {
+        printf("DEBUG: Erro ao resolver %s\n", name);
+        return;  // Nova consulta na próxima retransmissão
+    }
+    remote_addr = *ipaddr;
+    resolved = true;
+    for (int i = 0; i < TELEMETRY_WINDOW; i++) {
+        if (window[i].used && window[i].sends == 0) {
+            telemetry_transmit(&window[i]);
+        }
+    }
+}
+
+// Garante o endereço do receptor; false enquanto o DNS não responder
+static bool telemetry_resolve(void) {
+    if (resolved) {
+        return true;
+    }
+    if (!resolving) {
+        err_t err = dns_gethostbyname(remote_host, &remote_addr, telemetry_dns_found, NULL);
+        if (err == ERR_OK) {
+            resolved = true;  // Endereço IP literal ou nome já no cache do lwIP
+        } else if (err == ERR_INPROGRESS) {
+            resolving = true;
+        }
+    }
+    return resolved;
+}
+
+// Envia (ou reenvia) um registro da janela. Sem enlace ou sem endereço o envio
+// não conta como tentativa: o registro espera na janela.
+static err_t telemetry_transmit(telemetry_slot_t *slot) {
+    slot->last_send_ms = to_ms_since_boot(get_absolute_time());
+    if (wifi_link_state() != WIFI_LINK_UP || !telemetry_resolve()) {
+        return ERR_RTE;
+    }
+    struct pbuf *p = pbuf_alloc(PBUF_TRANSPORT, sizeof(slot->data), PBUF_RAM);
+    if (!p) {
+        return ERR_MEM;
+    }
+    memcpy(p->payload, slot->data, sizeof(slot->data));
+    err_t err = udp_sendto(pcb, p, &remote_addr, remote_port);
+    pbuf_free(p);
+    slot->sends++;
+    return err;
+}
+
+// Verifica a janela periodicamente enquanto houver registros sem confirmação
+static void telemetry_retry(void *arg) {
+    uint32_t now = to_ms_since_boot(get_absolute_time());
+    for (int i = 0; i < TELEMETRY_WINDOW; i++) {
+        telemetry_slot_t *slot = &window[i];
+        if (!slot->used || now - slot->last_send_ms < TELEMETRY_RETRY_MS) {
+            continue;
+        }
+        if (slot->sends >= TELEMETRY_MAX_SENDS) {
+            printf("DEBUG: Telemetria seq %u sem confirmacao; descartada\n", (unsigned)slot->seq);
+            slot->used = false;
+            in_window--;
+            stats.lost++;
+            continue;
+        }
+        if (slot->sends) {
+            stats.retransmits++;
+        }
+        telemetry_transmit(slot);
+    }
+    retry_armed = in_window > 0;
+    if (retry_armed) {
+        sys_timeout(TELEMETRY_RETRY_MS, telemetry_retry, NULL);
+    }
+}
+
+// Confirmações do receptor (contexto do lwIP)
+static void telemetry_recv(void *arg, struct udp_pcb *upcb, struct pbuf *p, const ip_addr_t *addr, u16_t port) {
+    uint8_t ack[TELEMETRY_HEADER_SIZE];
+    if (pbuf_copy_partial(p, ack, sizeof(ack), 0) == sizeof(ack) &&
+        ack[0] == TELEMETRY_MAGIC_0 && ack[1] == TELEMETRY_MAGIC_1 &&
+        ack[2] == TELEMETRY_VERSION && ack[3] == TELEMETRY_TYPE_ACK &&
+        get_u32(ack + 4) == device_id && get_u32(ack + 8) == session) {
+        uint32_t seq = get_u32(ack + 12);
+        for (int i = 0; i < TELEMETRY_WINDOW; i++) {
+            if (window[i].used && window[i].seq == seq) {
+                window[i].used = false;
+                in_window--;
+                stats.acked++;
+                break;
+            }
+        }
+    }
+    pbuf_free(p);
+}
+
+bool telemetry_init(const char *host, uint16_t port) {
+    bool ok = false;
+    cyw43_arch_lwip_begin();
+    if (!pcb) {
+        remote_host = host;
+        remote_port = port;
+        resolved = false;  // Resolvido no primeiro envio, quando a rede já estiver ativa
+        device_id = telemetry_device_id();
+        session = get_rand_32();
+        pcb = udp_new_ip_type(IPADDR_TYPE_ANY);
+        if (pcb && udp_bind(pcb, IP_ADDR_ANY, 0) == ERR_OK) {
+            udp_recv(pcb, telemetry_recv, NULL);
+            ok = true;
+        } else if (pcb) {
+            udp_remove(pcb);
+            pcb = NULL;
+        }
+    }
+    cyw43_arch_lwip_end();
+    if (!ok) {
+        printf("DEBUG: Falha ao iniciar telemetria UDP\n");
+    }
+    return ok;
+}
+
+bool telemetry_send_round(const game_round_t *round) {
+    bool ok = false;
+    cyw43_arch_lwip_begin();
+    telemetry_slot_t *slot = NULL;
+    for (int i = 0; pcb && i < TELEMETRY_WINDOW && !slot; i++) {
+        if (!window[i].used) {
+            slot = &window[i];
+        }
+    }
+    if (slot) {
+        slot->used = true;
+        slot->sends = 0;
+        slot->seq = next_seq++;
+        uint8_t *d = slot->data;
+        telemetry_put_header(d, TELEMETRY_TYPE_ROUND, slot->seq, to_ms_since_boot(get_absolute_time()));
+        put_u16(d + 20, round->round);
+        d[22] = round->expected_red;
+        d[23] = round->user_red;
+        d[24] = round->expected_blue;
+        d[25] = round->user_blue;
+        d[26] = round->success ? 0x01 : 0x00;
+        put_u64(d + 27, round->start_us);
+        put_u64(d + 35, round->end_us);
+        in_window++;
+        stats.sent++;
+        telemetry_transmit(slot);  // Falha no envio é tratada como perda: a retransmissão cobre
+        if (!retry_armed) {
+            retry_armed = true;
+            sys_timeout(TELEMETRY_RETRY_MS, telemetry_retry, NULL);
+        }
+        ok = true;
+    } else {
+        stats.dropped++;
+    }
+    cyw43_arch_lwip_end();
+    return ok;
+}
+
+uint32_t telemetry_pending(void) {
+    return in_window;
+}
+
+void telemetry_get_stats(telemetry_stats_t *out) {
+    cyw43_arch_lwip_begin();
+    *out = stats;
+    cyw43_arch_lwip_end();
+}
@@ -0,0 +1,69 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "result_queue.h"     // game_round_t
+
+// ----- Protocolo (todos os campos em little-endian) -----
+//
+// Cabeçalho comum (20 bytes):
+//   0  magic      "LR"
+//   2  versão     TELEMETRY_VERSION
+//   3  tipo       TELEMETRY_TYPE_*
+//   4  device_id  uint32 derivado do ID único da placa
+//   8  session    uint32 aleatório sorteado a cada boot
+//  12  seq        uint32, cresce a cada registro enviado (recomeça em 0 a cada boot)
+//  16  timestamp  uint32, ms desde o boot no momento do evento
+//
+// O receptor identifica retransmissões por (device_id, session, seq): sem a
+// sessão, os primeiros registros após um reboot pareceriam repetidos.
+//
+// Registro de rodada (TELEMETRY_TYPE_ROUND, +23 bytes):
+//  20  round      uint16
+//  22  expected_red, user_red, expected_blue, user_blue   uint8 cada
+//  26  flags      bit 0 = acertou
+//  27  start_us   uint64, exibição do padrão em µs desde 1970 UTC (0 = relógio não sincronizado)
+//  35  end_us     uint64, fim do tempo de resposta
+//
+// Confirmação (TELEMETRY_TYPE_ACK): apenas o cabeçalho, com a sessão e o seq confirmados.
+#define TELEMETRY_MAGIC_0 'L'
+#define TELEMETRY_MAGIC_1 'R'
+#define TELEMETRY_VERSION 3
+#define TELEMETRY_TYPE_ROUND 1
+#define TELEMETRY_TYPE_ACK 2
+#define TELEMETRY_HEADER_SIZE 20
+#define TELEMETRY_ROUND_SIZE (TELEMETRY_HEADER_SIZE + 23)
+
+// Registros aguardando confirmação ao mesmo tempo
+#define TELEMETRY_WINDOW 16
+
+// Intervalo entre retransmissões e número máximo de envios de um registro
+#define TELEMETRY_RETRY_MS 500
+#define TELEMETRY_MAX_SENDS 6
+
+// Contadores do transporte
+typedef struct {
+    uint32_t sent;          // Registros enviados pela primeira vez
+    uint32_t retransmits;   // Reenvios por falta de confirmação
+    uint32_t acked;         // Registros confirmados
+    uint32_t lost;          // Registros abandonados após TELEMETRY_MAX_SENDS envios
+    uint32_t dropped;       // Registros recusados com a janela cheia
+} telemetry_stats_t;
+
+// Abre o socket UDP para o receptor em "host" (nome ou endereço IP em texto) e
+// "port". O nome é resolvido por DNS no primeiro envio e mantido em cache.
+bool telemetry_init(const char *host, uint16_t port);
+
+// Envia o resultado de uma rodada em um único datagrama; o registro é
+// reenviado até ser confirmado. Retorna false se a janela estiver cheia.
+// Pode ser chamada fora do contexto do lwIP (usa cyw43_arch_lwip_begin/end).
+bool telemetry_send_round(const game_round_t *round);
+
+// Registros ainda sem confirmação
+uint32_t telemetry_pending(void);
+
+// Cópia dos contadores
+void telemetry_get_stats(telemetry_stats_t *out);
+
+#endif // TELEMETRY_H
@@ -0,0 +1,143 @@
+#include "wifi_link.h"
+
+#include <stdio.h>
+
+#include "pico/cyw43_arch.h"   // Driver do módulo Wi-Fi e estado do enlace
+#include "lwip/netif.h"        // Callbacks de status e de enlace da interface
+#include "lwip/timeouts.h"     // sys_timeout() para tentativas e backoff
+
+// ----- Estado do gerenciador (acessado no contexto do lwIP) -----
+static const char *link_ssid;
+static const char *link_password;
+static uint32_t link_auth;
+static volatile wifi_link_state_t link_state;
+static wifi_link_state_fn state_fn;
+static uint32_t backoff_ms;             // Próxima espera após uma falha
+static uint32_t attempt_start_ms;       // Início da tentativa atual
+static volatile uint32_t connects;
+
+// Callbacks anteriores da interface, chamados em seguida
+static netif_status_callback_fn prev_status_cb;
+static netif_status_callback_fn prev_link_cb;
+
+static void wifi_link_attempt(void *arg);
+static void wifi_link_poll(void *arg);
+
+static inline struct netif *sta_netif(void) {
+    return &cyw43_state.netif[CYW43_ITF_STA];
+}
+
+static void wifi_link_set_state(wifi_link_state_t state) {
+    if (state == link_state) {
+        return;
+    }
+    link_state = state;
+    if (state_fn) {
+        state_fn(state);
+    }
+}
+
+// Falha ou queda: agenda nova tentativa e dobra a espera seguinte
+static void wifi_link_schedule_retry(void) {
+    sys_untimeout(wifi_link_poll, NULL);
+    sys_untimeout(wifi_link_attempt, NULL);
+    wifi_link_set_state(WIFI_LINK_DOWN);
+    printf("DEBUG: WiFi: nova tentativa em %u ms\n", (unsigned)backoff_ms);
+    sys_timeout(backoff_ms, wifi_link_attempt, NULL);
+    backoff_ms = backoff_ms * 2 > WIFI_LINK_BACKOFF_MAX_MS ? WIFI_LINK_BACKOFF_MAX_MS : backoff_ms * 2;
+}
+
+// Inicia uma associação sem bloquear; o resultado chega pelos callbacks e por wifi_link_poll()
+static void wifi_link_attempt(void *arg) {
+    printf("DEBUG: WiFi: conectando a %s...\n", link_ssid);
+    wifi_link_set_state(WIFI_LINK_CONNECTING);
+    attempt_start_ms = to_ms_since_boot(get_absolute_time());
+    if (cyw43_arch_wifi_connect_async(link_ssid, link_password, link_auth) != 0) {
+        wifi_link_schedule_retry();
+        return;
+    }
+    sys_timeout(WIFI_LINK_POLL_MS, wifi_link_poll, NULL);
+}
+
+// Acompanha a tentativa: o driver só informa falhas (senha errada, rede ausente) pelo status
+static void wifi_link_poll(void *arg) {
+    if (link_state != WIFI_LINK_CONNECTING) {
+        return;
+    }
+    int status = cyw43_tcpip_link_status(&cyw43_state, CYW43_ITF_STA);
+    if (status == CYW43_LINK_UP) {
+        return;  // O callback de status já tratou (ou vai tratar) a conexão
+    }
+    uint32_t elapsed = to_ms_since_boot(get_absolute_time()) - attempt_start_ms;
+    if (status < 0 || elapsed > WIFI_LINK_CONNECT_TIMEOUT_MS) {
+        printf("DEBUG: WiFi: falha na tentativa (status %d)\n", status);
+        wifi_link_schedule_retry();
+        return;
+    }
+    sys_timeout(WIFI_LINK_POLL_MS, wifi_link_poll, NULL);
+}
+
+// Interface ativa com endereço: enlace pronto para uso
+static void wifi_link_status_cb(struct netif *netif) {
+    if (netif_is_up(netif) && netif_is_link_up(netif) && ip4_addr_get_u32(netif_ip4_addr(netif)) != 0 &&
+        link_state != WIFI_LINK_UP) {
+        sys_untimeout(wifi_link_poll, NULL);
+        backoff_ms = WIFI_LINK_BACKOFF_MIN_MS;
+        connects++;
+        printf("DEBUG: WiFi: conectado, IP %s\n", ip4addr_ntoa(netif_ip4_addr(netif)));
+        wifi_link_set_state(WIFI_LINK_UP);
+    }
+    if (prev_status_cb) {
+        prev_status_cb(netif);
+    }
+}
+
+// Queda do enlace (ponto de acesso sumiu, desautenticação): reconecta com backoff
+static void wifi_link_link_cb(struct netif *netif) {
+    if (!netif_is_link_up(netif) && link_state == WIFI_LINK_UP) {
+        printf("DEBUG: WiFi: enlace perdido\n");
+        wifi_link_schedule_retry();
+    }
+    if (prev_link_cb) {
+        prev_link_cb(netif);
+    }
+}
+
+bool wifi_link_start(const char *ssid, const char *password, uint32_t auth) {
+    if (cyw43_arch_init()) {
+        return false;
+    }
+    cyw43_arch_enable_sta_mode();
+
+    cyw43_arch_lwip_begin();
+    link_ssid = ssid;
+    link_password = password;
+    link_auth = auth;
+    backoff_ms = WIFI_LINK_BACKOFF_MIN_MS;
+    struct netif *n = sta_netif();
+    prev_status_cb = n->status_callback;
+    prev_link_cb = n->link_callback;
+    netif_set_status_callback(n, wifi_link_status_cb);
+    netif_set_link_callback(n, wifi_link_link_cb);
+    wifi_link_attempt(NULL);
+    cyw43_arch_lwip_end();
+    return true;
+}
+
+void wifi_link_set_callback(wifi_link_state_fn fn) {
+    cyw43_arch_lwip_begin();
+    state_fn = fn;
+    cyw43_arch_lwip_end();
+}
+
+wifi_link_state_t wifi_link_state(void) {
+    return link_state;
+}
+
+uint32_t wifi_link_ip(void) {
+    return link_state == WIFI_LINK_UP ? ip4_addr_get_u32(netif_ip4_addr(sta_netif())) : 0;
+}
+
+uint32_t wifi_link_connects(void) {
+    return connects;
+}
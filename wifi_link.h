@@ -0,0 +1,44 @@
+#ifndef WIFI_LINK_H
+#define WIFI_LINK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Tempo máximo de uma tentativa de associação + DHCP
+#define WIFI_LINK_CONNECT_TIMEOUT_MS 20000
+
+// Espera entre tentativas: começa em MIN e dobra a cada falha até MAX
+#define WIFI_LINK_BACKOFF_MIN_MS 1000
+#define WIFI_LINK_BACKOFF_MAX_MS 60000
+
+// Intervalo de verificação enquanto uma tentativa está em andamento
+#define WIFI_LINK_POLL_MS 250
+
+// Estado do enlace
+typedef enum {
+    WIFI_LINK_DOWN = 0,       // Sem conexão; nova tentativa agendada
+    WIFI_LINK_CONNECTING,     // Associação/DHCP em andamento
+    WIFI_LINK_UP              // Associado e com endereço IP
+} wifi_link_state_t;
+
+// Chamado no contexto do lwIP a cada mudança de estado
+typedef void (*wifi_link_state_fn)(wifi_link_state_t state);
+
+// Inicia o módulo Wi-Fi em modo estação e começa a associação em segundo
+// plano; retorna imediatamente. Reconecta sozinho se o enlace cair.
+// Retorna false apenas se o módulo (e o lwIP) não puder ser iniciado.
+bool wifi_link_start(const char *ssid, const char *password, uint32_t auth);
+
+// Registra quem deve ser avisado das mudanças de estado
+void wifi_link_set_callback(wifi_link_state_fn fn);
+
+// Estado atual do enlace
+wifi_link_state_t wifi_link_state(void);
+
+// Endereço IPv4 atual (0 se não houver), na ordem de rede
+uint32_t wifi_link_ip(void);
+
+// Conexões estabelecidas desde o boot (a primeira inclusa)
+uint32_t wifi_link_connects(void);
+
+#endif // WIFI_LINK_H